@@ -0,0 +1,604 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include "comum/grafos.h"
+
+using namespace std;
+
+// Hierarquias de Contração (Contraction Hierarchies) sobre o Dijkstra.
+// Pré-processamento: contrai os vértices do menos ao mais importante; ao
+// contrair v, cada par de vizinhos (u, w) cujo menor caminho passa por v
+// ganha um atalho u-w (a busca de testemunha é um Dijkstra limitado).
+// Consulta: Dijkstra bidirecional que só sobe na hierarquia.
+
+// Lista de Adjacência: vector de pares {destino, peso}
+using Grafo = vector<vector<pair<int, int>>>; // {destino, peso}
+
+// Estrutura para a Fila de Prioridade: {distancia_total, vertice}
+using PQ_Item = pair<long long, int>; // {distancia_total, vertice}
+using MinHeap = priority_queue<PQ_Item, vector<PQ_Item>, greater<PQ_Item>>;
+
+// Constante para representar o infinito (long long para distâncias grandes)
+const long long INFINITO = numeric_limits<long long>::max();
+
+// Limite de vértices assentados por busca de testemunha (na contração de
+// fato e na simulação usada para calcular prioridades). Se a busca parar
+// antes de achar a testemunha, o atalho é criado mesmo assim: fica um atalho
+// a mais, nunca uma resposta errada.
+const int LIMITE_TESTEMUNHA = 500;
+const int LIMITE_SIMULACAO = 50;
+
+// Aresta do grafo em contração (pesos long long: atalhos somam pesos)
+struct ArestaCH {
+    int v;
+    long long peso;
+};
+
+// Hierarquia pronta: só as arestas que sobem (para vértices de nível maior),
+// em formato CSR. Como o grafo é não-direcionado, elas servem às duas buscas.
+struct Hierarquia {
+    int num_vertices = 0;
+    vector<int32_t> nivel;   // nivel[v]: posição de v na ordem de contração (1..V)
+    vector<int32_t> ordem;   // ordem[k]: vértice de nível k
+    vector<int64_t> inicio;  // arestas de v: [inicio[v], inicio[v + 1])
+    vector<int32_t> destino;
+    vector<int64_t> peso;
+};
+
+void print_help() {
+    cout << "Uso: ./ch -f <arquivo> -p <hierarquia>" << endl;
+    cout << "       ./ch -c <hierarquia> -i <origem> [-t <destino>] [-o <saida>]" << endl;
+    cout << "       ./ch -c <hierarquia> -q <consultas>" << endl;
+    cout << "  -h : mostra este help" << endl;
+    cout << "  -o : redireciona a saida para o arquivo" << endl;
+    cout << "  -f : indica o arquivo que contem o grafo de entrada ('-' para stdin)" << endl;
+    cout << "  -n : entrada sem cabecalho (V e M inferidos das arestas)" << endl;
+    cout << "  -p : pre-processa o grafo (-f) e grava a hierarquia no arquivo" << endl;
+    cout << "  -c : carrega a hierarquia do arquivo (sem -c, ela e construida a partir de -f)" << endl;
+    cout << "  -i : vertice inicial (sem -t, mostra a distancia para todos os vertices)" << endl;
+    cout << "  -t : vertice destino (consulta ponto a ponto)" << endl;
+    cout << "  -q : arquivo com pares 'origem destino' por linha ('-' para stdin)" << endl;
+}
+
+// Dijkstra limitado usado como busca de testemunha. Reaproveita os vetores
+// entre buscas: só os vértices tocados são reiniciados.
+class BuscaTestemunha {
+private:
+    vector<long long> distancias;
+    vector<bool> alvo;
+    vector<int> tocados;
+    MinHeap pq;
+
+public:
+    void inicializa(int num_vertices) {
+        distancias.assign(num_vertices + 1, INFINITO);
+        alvo.assign(num_vertices + 1, false);
+    }
+
+    // Marca os vértices cuja distância interessa; a busca para quando
+    // todos eles forem assentados.
+    void define_alvos(const vector<ArestaCH>& vizinhos, size_t primeiro) {
+        for (size_t j = primeiro; j < vizinhos.size(); ++j) alvo[vizinhos[j].v] = true;
+    }
+
+    // Menores distâncias a partir de 'origem' sem passar por 'ignorado',
+    // até 'limite' de distância, 'max_assentados' vértices ou 'num_alvos'
+    // alvos assentados.
+    void executa(const vector<vector<ArestaCH>>& g, int origem, int ignorado, long long limite, int max_assentados,
+                 int num_alvos) {
+        distancias[origem] = 0;
+        tocados.push_back(origem);
+        pq.push({0, origem});
+
+        int assentados = 0;
+        while (!pq.empty() && num_alvos > 0) {
+            long long d_atual = pq.top().first;
+            int u = pq.top().second;
+            pq.pop();
+            if (d_atual > distancias[u]) continue;
+            if (d_atual > limite || ++assentados > max_assentados) break;
+            if (alvo[u]) --num_alvos;
+
+            for (const auto& aresta : g[u]) {
+                if (aresta.v == ignorado) continue;
+                long long d_nova = d_atual + aresta.peso;
+                if (d_nova < distancias[aresta.v]) {
+                    if (distancias[aresta.v] == INFINITO) tocados.push_back(aresta.v);
+                    distancias[aresta.v] = d_nova;
+                    pq.push({d_nova, aresta.v});
+                }
+            }
+        }
+    }
+
+    long long distancia(int v) const { return distancias[v]; }
+
+    void limpa(const vector<ArestaCH>& vizinhos) {
+        for (const auto& aresta : vizinhos) alvo[aresta.v] = false;
+        for (int v : tocados) distancias[v] = INFINITO;
+        tocados.clear();
+        pq = MinHeap();
+    }
+};
+
+// Pré-processamento: ordena os vértices por importância e contrai
+class Contrator {
+private:
+    int num_vertices;
+    vector<vector<ArestaCH>> g;          // Grafo restante (vértices ainda não contraídos)
+    vector<vector<ArestaCH>> subida;     // Arestas para cima de cada vértice contraído
+    vector<int> vizinhos_contraidos;
+    vector<int> prioridade_atual;
+    BuscaTestemunha busca;
+
+    void adiciona_aresta(int u, int v, long long peso) {
+        for (auto& aresta : g[u]) {
+            if (aresta.v == v) {
+                aresta.peso = min(aresta.peso, peso);
+                return;
+            }
+        }
+        g[u].push_back({v, peso});
+    }
+
+    // Conta (e, se 'aplica', cria) os atalhos necessários ao contrair v
+    int atalhos(int v, bool aplica) {
+        const vector<ArestaCH> vizinhos = g[v];
+        int total = 0;
+        for (size_t i = 0; i < vizinhos.size(); ++i) {
+            long long maior_via = 0;
+            for (size_t j = i + 1; j < vizinhos.size(); ++j) {
+                maior_via = max(maior_via, vizinhos[i].peso + vizinhos[j].peso);
+            }
+            if (i + 1 == vizinhos.size()) break;
+
+            busca.define_alvos(vizinhos, i + 1);
+            busca.executa(g, vizinhos[i].v, v, maior_via, aplica ? LIMITE_TESTEMUNHA : LIMITE_SIMULACAO,
+                          (int)(vizinhos.size() - i - 1));
+            for (size_t j = i + 1; j < vizinhos.size(); ++j) {
+                long long via = vizinhos[i].peso + vizinhos[j].peso;
+                if (busca.distancia(vizinhos[j].v) > via) {
+                    ++total;
+                    if (aplica) {
+                        adiciona_aresta(vizinhos[i].v, vizinhos[j].v, via);
+                        adiciona_aresta(vizinhos[j].v, vizinhos[i].v, via);
+                    }
+                }
+            }
+            busca.limpa(vizinhos);
+        }
+        return total;
+    }
+
+    // Diferença de arestas + vizinhos já contraídos (espalha a contração)
+    int prioridade(int v) {
+        return atalhos(v, false) - (int)g[v].size() + vizinhos_contraidos[v];
+    }
+
+    void contrai(int v) {
+        atalhos(v, true);
+        subida[v] = g[v];
+        for (const auto& aresta : g[v]) {
+            auto& lista = g[aresta.v];
+            for (size_t k = 0; k < lista.size(); ++k) {
+                if (lista[k].v == v) {
+                    lista[k] = lista.back();
+                    lista.pop_back();
+                    break;
+                }
+            }
+            vizinhos_contraidos[aresta.v]++;
+        }
+        g[v].clear();
+        g[v].shrink_to_fit();
+    }
+
+public:
+    Contrator(const Grafo& adj, int N)
+        : num_vertices(N), g(N + 1), subida(N + 1), vizinhos_contraidos(N + 1, 0), prioridade_atual(N + 1, 0) {
+        for (int u = 1; u <= N; ++u) {
+            for (const auto& aresta : adj[u]) {
+                if (aresta.first != u) adiciona_aresta(u, aresta.first, aresta.second);
+            }
+        }
+        busca.inicializa(N);
+    }
+
+    Hierarquia constroi() {
+        Hierarquia h;
+        h.num_vertices = num_vertices;
+        h.nivel.assign(num_vertices + 1, 0);
+        h.ordem.assign(num_vertices + 1, 0);
+
+        // Heap de {prioridade, vértice}; entradas com prioridade desatualizada são ignoradas
+        using ItemPrio = pair<int, int>;
+        priority_queue<ItemPrio, vector<ItemPrio>, greater<ItemPrio>> fila;
+        for (int v = 1; v <= num_vertices; ++v) {
+            prioridade_atual[v] = prioridade(v);
+            fila.push({prioridade_atual[v], v});
+        }
+
+        int proximo_nivel = 1;
+        while (!fila.empty()) {
+            int p = fila.top().first;
+            int v = fila.top().second;
+            fila.pop();
+            if (h.nivel[v] != 0 || p != prioridade_atual[v]) continue;
+
+            // Atualização preguiçosa: se piorou, volta para a fila
+            int nova = prioridade(v);
+            if (!fila.empty() && nova > fila.top().first) {
+                prioridade_atual[v] = nova;
+                fila.push({nova, v});
+                continue;
+            }
+
+            h.nivel[v] = proximo_nivel;
+            h.ordem[proximo_nivel] = v;
+            ++proximo_nivel;
+
+            // As prioridades dos vizinhos mudam; elas são corrigidas de forma
+            // preguiçosa quando chegam ao topo da fila.
+            contrai(v);
+        }
+        // CSR das arestas para cima
+        h.inicio.assign(num_vertices + 2, 0);
+        for (int v = 1; v <= num_vertices; ++v) {
+            h.inicio[v + 1] = h.inicio[v] + (int64_t)subida[v].size();
+        }
+        h.destino.reserve(h.inicio[num_vertices + 1]);
+        h.peso.reserve(h.inicio[num_vertices + 1]);
+        for (int v = 1; v <= num_vertices; ++v) {
+            for (const auto& aresta : subida[v]) {
+                h.destino.push_back(aresta.v);
+                h.peso.push_back(aresta.peso);
+            }
+            vector<ArestaCH>().swap(subida[v]);
+        }
+        return h;
+    }
+};
+
+// Formato binário: "CH01", int32 V, int32 nivel[V], int64 inicio[V + 2],
+// int32 destino[M], int64 peso[M] (M = inicio[V + 1])
+bool salva_hierarquia(const string& filename, const Hierarquia& h) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erro: Nao foi possivel criar o arquivo da hierarquia: " << filename << endl;
+        return false;
+    }
+    int32_t n = h.num_vertices;
+    file.write("CH01", 4);
+    file.write((const char*)&n, sizeof(n));
+    file.write((const char*)(h.nivel.data() + 1), n * sizeof(int32_t));
+    file.write((const char*)h.inicio.data(), (n + 2) * sizeof(int64_t));
+    file.write((const char*)h.destino.data(), h.destino.size() * sizeof(int32_t));
+    file.write((const char*)h.peso.data(), h.peso.size() * sizeof(int64_t));
+    return (bool)file;
+}
+
+bool carrega_hierarquia(const string& filename, Hierarquia& h) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erro: Nao foi possivel abrir o arquivo da hierarquia: " << filename << endl;
+        return false;
+    }
+    char magic[4];
+    int32_t n;
+    if (!file.read(magic, 4) || string(magic, 4) != "CH01" || !file.read((char*)&n, sizeof(n)) || n < 0) {
+        cerr << "Erro: Arquivo de hierarquia invalido: " << filename << endl;
+        return false;
+    }
+
+    h.num_vertices = n;
+    h.nivel.assign(n + 1, 0);
+    h.ordem.assign(n + 1, 0);
+    h.inicio.assign(n + 2, 0);
+    file.read((char*)(h.nivel.data() + 1), n * sizeof(int32_t));
+    file.read((char*)h.inicio.data(), (n + 2) * sizeof(int64_t));
+    int64_t m = file ? h.inicio[n + 1] : 0;
+    h.destino.resize(m);
+    h.peso.resize(m);
+    file.read((char*)h.destino.data(), m * sizeof(int32_t));
+    file.read((char*)h.peso.data(), m * sizeof(int64_t));
+    if (!file) {
+        cerr << "Erro: Arquivo de hierarquia truncado: " << filename << endl;
+        return false;
+    }
+    for (int v = 1; v <= n; ++v) {
+        if (h.nivel[v] < 1 || h.nivel[v] > n) {
+            cerr << "Erro: Arquivo de hierarquia invalido: " << filename << endl;
+            return false;
+        }
+        h.ordem[h.nivel[v]] = v;
+    }
+    return true;
+}
+
+// Consultas sobre a hierarquia. Os vetores de distância são reaproveitados
+// entre consultas e reiniciados só nos vértices tocados.
+class ConsultaCH {
+private:
+    const Hierarquia& h;
+    vector<long long> distancias[2]; // 0 = busca da origem, 1 = busca do destino
+    vector<int> tocados[2];
+    MinHeap pq[2];
+
+public:
+    explicit ConsultaCH(const Hierarquia& hierarquia) : h(hierarquia) {
+        for (int lado = 0; lado < 2; ++lado) distancias[lado].assign(h.num_vertices + 1, INFINITO);
+    }
+
+    // Dijkstra bidirecional só subindo na hierarquia. Para quando o topo das
+    // duas filas já não pode melhorar a melhor distância encontrada.
+    long long consulta(int origem, int destino, size_t& assentados) {
+        assentados = 0;
+        int pontas[2] = {origem, destino};
+        for (int lado = 0; lado < 2; ++lado) {
+            distancias[lado][pontas[lado]] = 0;
+            tocados[lado].push_back(pontas[lado]);
+            pq[lado].push({0, pontas[lado]});
+        }
+
+        long long melhor = INFINITO;
+        while (!pq[0].empty() || !pq[1].empty()) {
+            // Avança o lado com o menor topo
+            int lado;
+            if (pq[0].empty()) lado = 1;
+            else if (pq[1].empty()) lado = 0;
+            else lado = (pq[0].top().first <= pq[1].top().first) ? 0 : 1;
+
+            long long d_atual = pq[lado].top().first;
+            int u = pq[lado].top().second;
+            if (d_atual >= melhor) {
+                while (!pq[lado].empty()) pq[lado].pop(); // Este lado não melhora mais nada
+                continue;
+            }
+            pq[lado].pop();
+            if (d_atual > distancias[lado][u]) continue;
+
+            ++assentados;
+            if (distancias[1 - lado][u] != INFINITO) {
+                melhor = min(melhor, d_atual + distancias[1 - lado][u]);
+            }
+
+            // Stall-on-demand: se algum vizinho acima de u já oferece um
+            // caminho mais curto até u, o rótulo de u não é mínimo e não
+            // adianta expandi-lo.
+            bool parado = false;
+            for (int64_t k = h.inicio[u]; k < h.inicio[u + 1] && !parado; ++k) {
+                long long d_acima = distancias[lado][h.destino[k]];
+                parado = (d_acima != INFINITO && d_acima + h.peso[k] < d_atual);
+            }
+            if (parado) continue;
+
+            for (int64_t k = h.inicio[u]; k < h.inicio[u + 1]; ++k) {
+                int v = h.destino[k];
+                long long d_nova = d_atual + h.peso[k];
+                if (d_nova < distancias[lado][v]) {
+                    if (distancias[lado][v] == INFINITO) tocados[lado].push_back(v);
+                    distancias[lado][v] = d_nova;
+                    pq[lado].push({d_nova, v});
+                }
+            }
+        }
+
+        for (int lado = 0; lado < 2; ++lado) {
+            for (int v : tocados[lado]) distancias[lado][v] = INFINITO;
+            tocados[lado].clear();
+        }
+        return melhor == INFINITO ? -1 : melhor;
+    }
+
+    // Distância para todos os vértices (PHAST): busca para cima a partir da
+    // origem e depois uma varredura em ordem decrescente de nível, descendo
+    // pelas mesmas arestas.
+    vector<long long> consulta_todos(int origem) {
+        vector<long long> d(h.num_vertices + 1, INFINITO);
+        MinHeap fila;
+        d[origem] = 0;
+        fila.push({0, origem});
+        while (!fila.empty()) {
+            long long d_atual = fila.top().first;
+            int u = fila.top().second;
+            fila.pop();
+            if (d_atual > d[u]) continue;
+            for (int64_t k = h.inicio[u]; k < h.inicio[u + 1]; ++k) {
+                long long d_nova = d_atual + h.peso[k];
+                if (d_nova < d[h.destino[k]]) {
+                    d[h.destino[k]] = d_nova;
+                    fila.push({d_nova, h.destino[k]});
+                }
+            }
+        }
+
+        for (int nivel = h.num_vertices; nivel >= 1; --nivel) {
+            int v = h.ordem[nivel];
+            for (int64_t k = h.inicio[v]; k < h.inicio[v + 1]; ++k) {
+                long long d_acima = d[h.destino[k]];
+                if (d_acima != INFINITO && d_acima + h.peso[k] < d[v]) {
+                    d[v] = d_acima + h.peso[k];
+                }
+            }
+        }
+
+        for (int v = 1; v <= h.num_vertices; ++v) {
+            if (d[v] == INFINITO) d[v] = -1; // Vértice inalcançável
+        }
+        return d;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    string filename = "";
+    string hierarchy_out = "";
+    string hierarchy_in = "";
+    string queries_file = "";
+    string output_file = "";
+    bool no_header = false;
+    int start_node = -1;
+    int target_node = -1;
+
+    // 1. Parsing de Argumentos
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-h") {
+            print_help();
+            return 0;
+        } else if (arg == "-f" && i + 1 < argc) {
+            filename = argv[++i];
+        } else if (arg == "-p" && i + 1 < argc) {
+            hierarchy_out = argv[++i];
+        } else if (arg == "-c" && i + 1 < argc) {
+            hierarchy_in = argv[++i];
+        } else if (arg == "-q" && i + 1 < argc) {
+            queries_file = argv[++i];
+        } else if (arg == "-n") {
+            no_header = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if ((arg == "-i" || arg == "-t") && i + 1 < argc) {
+            int valor;
+            try {
+                valor = stoi(argv[++i]);
+            } catch (...) {
+                cerr << "Erro: Vertice (" << arg << ") invalido." << endl;
+                return 1;
+            }
+            (arg == "-i" ? start_node : target_node) = valor;
+        }
+    }
+
+    if (filename.empty() && hierarchy_in.empty()) {
+        print_help();
+        return 1;
+    }
+    if (filename == "-" && queries_file == "-") {
+        cerr << "Erro: -f e -q nao podem ler ambos da entrada padrao." << endl;
+        return 1;
+    }
+    // Se o -i não foi fornecido, assume 1 como padrão (como o dijkstra).
+    if (start_node == -1) {
+        start_node = 1;
+    }
+
+    // 2. Hierarquia: carregada do arquivo ou construída a partir do grafo
+    Hierarquia h;
+    if (!hierarchy_in.empty()) {
+        if (!carrega_hierarquia(hierarchy_in, h)) {
+            return 1;
+        }
+    } else {
+        Grafo adj;
+        int num_vertices;
+        if (!read_graph(filename, adj, num_vertices, no_header)) {
+            return 1;
+        }
+        auto inicio = chrono::steady_clock::now();
+        h = Contrator(adj, num_vertices).constroi();
+        auto fim = chrono::steady_clock::now();
+
+        if (!hierarchy_out.empty()) {
+            cerr << "Hierarquia: " << h.destino.size() << " arestas para cima em "
+                 << chrono::duration_cast<chrono::milliseconds>(fim - inicio).count() << " ms" << endl;
+            return salva_hierarquia(hierarchy_out, h) ? 0 : 1;
+        }
+    }
+
+    // Configuração da Saída (stdout ou arquivo)
+    ostream* out = &cout;
+    ofstream outfile;
+    if (!output_file.empty()) {
+        outfile.open(output_file);
+        if (outfile.is_open()) {
+            out = &outfile;
+        } else {
+            cerr << "Erro: Nao foi possivel abrir o arquivo de saida: " << output_file << endl;
+        }
+    }
+
+    ConsultaCH consulta(h);
+    auto valido = [&h](int v) { return v >= 1 && v <= h.num_vertices; };
+
+    // 3a. Lote de consultas: uma distância por linha e a latência média
+    if (!queries_file.empty()) {
+        ifstream queries;
+        istream* in = &cin;
+        if (queries_file != "-") {
+            queries.open(queries_file);
+            if (!queries.is_open()) {
+                cerr << "Erro: Nao foi possivel abrir o arquivo de consultas: " << queries_file << endl;
+                return 1;
+            }
+            in = &queries;
+        }
+
+        int s, t;
+        size_t total = 0, assentados = 0, soma_assentados = 0;
+        chrono::nanoseconds tempo(0);
+        while (*in >> s >> t) {
+            if (!valido(s) || !valido(t)) {
+                *out << -1 << '\n';
+                continue;
+            }
+            auto inicio = chrono::steady_clock::now();
+            long long d = consulta.consulta(s, t, assentados);
+            tempo += chrono::steady_clock::now() - inicio;
+            *out << d << '\n';
+            ++total;
+            soma_assentados += assentados;
+        }
+        if (total > 0) {
+            cerr << "Consultas: " << total << "  Vertices assentados (media): " << soma_assentados / total
+                 << "  Tempo medio: " << chrono::duration_cast<chrono::nanoseconds>(tempo).count() / total / 1000.0
+                 << " us" << endl;
+        }
+        return 0;
+    }
+
+    if (!valido(start_node)) {
+        cerr << "Erro: Vertice inicial (-i) fora do intervalo." << endl;
+        return 1;
+    }
+
+    // 3b. Consulta ponto a ponto
+    if (target_node != -1) {
+        if (!valido(target_node)) {
+            cerr << "Erro: Vertice destino (-t) fora do intervalo." << endl;
+            return 1;
+        }
+        size_t assentados = 0;
+        auto inicio = chrono::steady_clock::now();
+        long long d = consulta.consulta(start_node, target_node, assentados);
+        auto fim = chrono::steady_clock::now();
+
+        *out << target_node << ":" << d << '\n';
+        cerr << "Vertices assentados: " << assentados << "  Tempo: "
+             << chrono::duration_cast<chrono::microseconds>(fim - inicio).count() << " us" << endl;
+        return 0;
+    }
+
+    // 3c. Todos os destinos, no mesmo formato do dijkstra
+    vector<long long> distancias = consulta.consulta_todos(start_node);
+    if (out == &cout) {
+        for (int i = 1; i <= h.num_vertices; ++i) {
+            printf("%d:%lld ", i, distancias[i]);
+        }
+        printf("\n");
+    } else {
+        for (int i = 1; i <= h.num_vertices; ++i) {
+            *out << i << ":" << distancias[i] << " ";
+        }
+        *out << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+// Código compartilhado pelas ferramentas (dijkstra, prim, kruskal, kosaraju,
+// ch): leitura da entrada e reordenação de vértices. Cada Makefile
+// compila com -I.., então o include é "comum/grafos.h".
+#ifndef COMUM_GRAFOS_H
+#define COMUM_GRAFOS_H
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Leitor de inteiros em blocos (fread de 1 MB por vez), bem mais rápido que
+// o operator>> do ifstream. O nome "-" lê da entrada padrão, o que permite
+// usar a ferramenta como estágio de um pipeline, sem arquivo temporário.
+class LeitorRapido {
+private:
+    FILE* arquivo;
+    bool fechar;
+    std::vector<char> buffer;
+    size_t pos = 0, fim = 0;
+
+    int proximo_char() {
+        if (pos == fim) {
+            fim = fread(buffer.data(), 1, buffer.size(), arquivo);
+            pos = 0;
+            if (fim == 0) return EOF;
+        }
+        return (unsigned char)buffer[pos++];
+    }
+
+public:
+    explicit LeitorRapido(const std::string& filename) : buffer(1 << 20) {
+        fechar = (filename != "-");
+        arquivo = fechar ? fopen(filename.c_str(), "rb") : stdin;
+    }
+
+    ~LeitorRapido() {
+        if (fechar && arquivo) fclose(arquivo);
+    }
+
+    bool aberto() const { return arquivo != nullptr; }
+
+    // Lê o próximo inteiro; retorna false no fim da entrada, se não houver
+    // número ou se ele não couber em int
+    bool le(int& x) {
+        int c = proximo_char();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') c = proximo_char();
+        if (c == EOF) return false;
+
+        bool negativo = (c == '-');
+        if (negativo || c == '+') c = proximo_char();
+        if (c < '0' || c > '9') return false;
+
+        // Fora do intervalo de int é erro, não um valor truncado. Passado o
+        // limite, os dígitos restantes só são consumidos (sem estourar valor).
+        const long long limite =
+            negativo ? -(long long)std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+        long long valor = 0;
+        while (c >= '0' && c <= '9') {
+            if (valor <= limite) valor = valor * 10 + (c - '0');
+            c = proximo_char();
+        }
+        if (c != EOF) --pos; // Devolve o separador
+        if (valor > limite) return false;
+        x = (int)(negativo ? -valor : valor);
+        return true;
+    }
+};
+
+// Armazém em blocos grandes de tamanho fixo: crescer nunca copia o que já foi
+// lido (um vector realocaria e copiaria tudo a cada duplicação).
+template <typename T>
+class ArenaBlocos {
+private:
+    static const size_t TAMANHO_BLOCO = 1 << 16;
+    std::vector<std::unique_ptr<T[]>> blocos;
+    size_t total = 0;
+
+public:
+    void push_back(const T& x) {
+        if (total % TAMANHO_BLOCO == 0) blocos.emplace_back(new T[TAMANHO_BLOCO]);
+        blocos.back()[total % TAMANHO_BLOCO] = x;
+        ++total;
+    }
+
+    size_t size() const { return total; }
+
+    const T& operator[](size_t i) const { return blocos[i / TAMANHO_BLOCO][i % TAMANHO_BLOCO]; }
+};
+
+// Min-heap (priority_queue com greater) que pode ser esvaziado sem devolver a
+// memória do vetor interno (priority_queue não tem clear(); o vetor 'c' é
+// protegido). Usado pelas áreas de trabalho reaproveitadas entre execuções.
+template <typename Item>
+struct HeapReutilizavel : std::priority_queue<Item, std::vector<Item>, std::greater<Item>> {
+    void limpa() { this->c.clear(); }
+};
+
+// Lê a lista de arestas no formato das ferramentas ('filename' "-" = entrada
+// padrão). Com cabeçalho: "V M" seguido de M arestas "u v peso" (ou "u v",
+// sem peso). Sem cabeçalho (sem_cabecalho): só as arestas, até o fim da
+// entrada; V é o maior vértice visto até o momento. Os erros (arquivo,
+// cabeçalho, aresta incompleta, vértice fora de [1, V]) vão para stderr.
+//
+//     LeitorArestas leitor(filename, true, sem_cabecalho);
+//     if (!leitor.abre()) return false;
+//     while (leitor.proxima(u, v, peso)) { ... }
+//     if (leitor.erro()) return false;
+class LeitorArestas {
+private:
+    LeitorRapido file;
+    std::string nome;
+    bool com_peso, sem_cabecalho;
+    int vertices = 0;
+    int arestas = -1; // -1 = desconhecido: lê até o fim da entrada
+    int lidas = 0;
+    bool falhou = false;
+
+    bool falha_aresta() {
+        std::cerr << "Erro ao ler aresta " << lidas + 1 << "." << std::endl;
+        falhou = true;
+        return false;
+    }
+
+public:
+    LeitorArestas(const std::string& filename, bool com_peso, bool sem_cabecalho)
+        : file(filename), nome(filename), com_peso(com_peso), sem_cabecalho(sem_cabecalho) {}
+
+    // Abre a entrada e lê o cabeçalho (se houver)
+    bool abre() {
+        if (!file.aberto()) {
+            std::cerr << "Erro: Nao foi possivel abrir o arquivo: " << nome << std::endl;
+            return false;
+        }
+        if (!sem_cabecalho && !(file.le(vertices) && file.le(arestas))) {
+            std::cerr << "Erro ao ler V e M do arquivo." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    int num_vertices() const { return vertices; }
+    int num_arestas() const { return arestas; } // -1 sem cabeçalho
+    bool erro() const { return falhou; }
+
+    // Próxima aresta (peso = 0 sem peso). Retorna false no fim da lista ou
+    // em erro; erro() distingue os dois casos.
+    bool proxima(int& u, int& v, int& peso) {
+        if (falhou || (arestas >= 0 && lidas == arestas)) return false;
+        if (!file.le(u)) {
+            if (arestas < 0) return false; // Fim da entrada sem cabeçalho
+            return falha_aresta();
+        }
+        peso = 0;
+        if (!(file.le(v) && (!com_peso || file.le(peso)))) return falha_aresta();
+        if (sem_cabecalho) {
+            vertices = std::max(vertices, std::max(u, v));
+        }
+        if (u < 1 || v < 1 || u > vertices || v > vertices) {
+            std::cerr << "Erro: Vertice " << u << " ou " << v << " fora do intervalo [1, " << vertices << "]."
+                      << std::endl;
+            falhou = true;
+            return false;
+        }
+        ++lidas;
+        return true;
+    }
+};
+
+// Aresta como lida da entrada, antes de montar a lista de adjacência
+struct ArestaLida {
+    int u, v, peso;
+};
+
+// Lê um grafo não-direcionado com pesos (ver LeitorArestas) em 'adj',
+// {destino, peso}, cada aresta nas duas direções. As arestas vão primeiro
+// para uma arena; depois os graus são contados e cada lista de adjacência é
+// alocada uma única vez, no tamanho exato, e preenchida na ordem da entrada.
+inline bool read_graph(const std::string& filename, std::vector<std::vector<std::pair<int, int>>>& adj,
+                       int& num_vertices, bool sem_cabecalho) {
+    LeitorArestas leitor(filename, true, sem_cabecalho);
+    if (!leitor.abre()) return false;
+
+    ArenaBlocos<ArestaLida> arestas;
+    int u, v, peso;
+    while (leitor.proxima(u, v, peso)) arestas.push_back({u, v, peso});
+    if (leitor.erro()) return false;
+    num_vertices = leitor.num_vertices();
+
+    std::vector<int> grau(num_vertices + 1, 0);
+    for (size_t i = 0; i < arestas.size(); ++i) {
+        grau[arestas[i].u]++;
+        grau[arestas[i].v]++;
+    }
+
+    // V+1 listas para os vértices 1-based
+    adj.assign(num_vertices + 1, std::vector<std::pair<int, int>>());
+    for (int x = 1; x <= num_vertices; ++x) {
+        adj[x].reserve(grau[x]);
+    }
+
+    for (size_t i = 0; i < arestas.size(); ++i) {
+        const ArestaLida& a = arestas[i];
+        adj[a.u].push_back({a.v, a.peso});
+        adj[a.v].push_back({a.u, a.peso});
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Reordenação de vértices (--reorder): renumera os vértices para que vizinhos
+// fiquem próximos na memória, melhorando o uso de cache durante o algoritmo.
+// ---------------------------------------------------------------------------
+
+// Calcula a nova numeração: novo_id[v] é o rótulo (1-based) do vértice v.
+// 'vizinhos(v, saida)' acrescenta a saida os vizinhos de v (com repetição,
+// se houver arestas paralelas); o grau de v é quantos ele acrescenta.
+//   bfs    : ordem de visita de uma BFS (componente a componente)
+//   rcm    : Cuthill-McKee reverso (BFS partindo do vértice de menor grau,
+//            vizinhos em ordem crescente de grau, ordem final invertida)
+//   degree : grau decrescente (vértices muito acessados ficam juntos)
+// Retorna false se o método for desconhecido.
+template <typename Vizinhos>
+bool calcula_ordem(int num_vertices, const std::string& metodo, Vizinhos vizinhos, std::vector<int>& novo_id) {
+    if (metodo != "degree" && metodo != "bfs" && metodo != "rcm") return false;
+
+    std::vector<int> lista;
+    std::vector<size_t> grau(num_vertices + 1);
+    for (int v = 1; v <= num_vertices; ++v) {
+        lista.clear();
+        vizinhos(v, lista);
+        grau[v] = lista.size();
+    }
+    auto maior_grau = [&grau](int a, int b) { return grau[a] > grau[b]; };
+    auto menor_grau = [&grau](int a, int b) { return grau[a] < grau[b]; };
+
+    std::vector<int> ordem; // ordem[k] = vértice original que recebe o rótulo k + 1
+    ordem.reserve(num_vertices);
+
+    if (metodo == "degree") {
+        for (int v = 1; v <= num_vertices; ++v) ordem.push_back(v);
+        std::stable_sort(ordem.begin(), ordem.end(), maior_grau);
+    } else {
+        bool rcm = (metodo == "rcm");
+        std::vector<bool> visitados(num_vertices + 1, false);
+
+        // Raízes: ordem original (bfs) ou menor grau primeiro (rcm)
+        std::vector<int> raizes;
+        for (int v = 1; v <= num_vertices; ++v) raizes.push_back(v);
+        if (rcm) std::stable_sort(raizes.begin(), raizes.end(), menor_grau);
+
+        std::vector<int> novos;
+        for (int r : raizes) {
+            if (visitados[r]) continue;
+            visitados[r] = true;
+            size_t inicio = ordem.size();
+            ordem.push_back(r);
+            // A própria 'ordem' serve de fila da BFS
+            for (size_t k = inicio; k < ordem.size(); ++k) {
+                lista.clear();
+                vizinhos(ordem[k], lista);
+                novos.clear();
+                for (int w : lista) {
+                    if (!visitados[w]) {
+                        visitados[w] = true;
+                        novos.push_back(w);
+                    }
+                }
+                if (rcm) std::stable_sort(novos.begin(), novos.end(), menor_grau);
+                ordem.insert(ordem.end(), novos.begin(), novos.end());
+            }
+        }
+        if (rcm) std::reverse(ordem.begin(), ordem.end());
+    }
+
+    novo_id.assign(num_vertices + 1, 0);
+    for (int k = 0; k < num_vertices; ++k) {
+        novo_id[ordem[k]] = k + 1;
+    }
+    return true;
+}
+
+// Versão para listas de adjacência com peso ({destino, peso})
+inline bool calcula_ordem(const std::vector<std::vector<std::pair<int, int>>>& adj, int num_vertices,
+                          const std::string& metodo, std::vector<int>& novo_id) {
+    return calcula_ordem(num_vertices, metodo, [&adj](int v, std::vector<int>& saida) {
+        for (const auto& aresta : adj[v]) saida.push_back(aresta.first);
+    }, novo_id);
+}
+
+// Rótulo novo de uma entrada da lista de adjacência (sem peso ou {destino, peso})
+inline int renomeia(int v, const std::vector<int>& novo_id) { return novo_id[v]; }
+inline std::pair<int, int> renomeia(const std::pair<int, int>& aresta, const std::vector<int>& novo_id) {
+    return {novo_id[aresta.first], aresta.second};
+}
+
+// Reconstrói o grafo com os novos rótulos; as listas de adjacência ficam
+// ordenadas pelo rótulo do vizinho, para um acesso mais sequencial.
+template <typename Aresta>
+std::vector<std::vector<Aresta>> permuta_grafo(const std::vector<std::vector<Aresta>>& adj, int num_vertices,
+                                               const std::vector<int>& novo_id) {
+    std::vector<std::vector<Aresta>> permutado(num_vertices + 1);
+    for (int v = 1; v <= num_vertices; ++v) {
+        auto& lista = permutado[novo_id[v]];
+        lista.reserve(adj[v].size());
+        for (const auto& aresta : adj[v]) {
+            lista.push_back(renomeia(aresta, novo_id));
+        }
+        std::sort(lista.begin(), lista.end());
+    }
+    return permutado;
+}
+
+#endif
@@ -0,0 +1,55 @@
+// Despacho de kernels vetoriais compartilhado (dijkstra, prim): detecção do
+// conjunto de instruções da CPU e interpretação do --simd. Cada ferramenta
+// mapeia o nível escolhido para os seus próprios kernels.
+#ifndef COMUM_SIMD_H
+#define COMUM_SIMD_H
+
+#include <string>
+
+// Kernels AVX2/AVX-512 só em x86 com GCC/Clang (atributo target e
+// __builtin_cpu_supports); nos demais, só o escalar existe.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// Níveis em ordem crescente: um nível suportado implica os anteriores
+enum class NivelSimd { escalar, avx2, avx512 };
+
+// Melhor nível que a CPU em execução suporta
+inline NivelSimd nivel_simd_cpu() {
+#ifdef KERNELS_X86
+    if (__builtin_cpu_supports("avx512f")) return NivelSimd::avx512;
+    if (__builtin_cpu_supports("avx2")) return NivelSimd::avx2;
+#endif
+    return NivelSimd::escalar;
+}
+
+// Interpreta o --simd: "auto" usa o melhor que a CPU suporta; "scalar",
+// "avx2" e "avx512" forçam um. Retorna false se o modo for desconhecido ou
+// se a CPU não suportar o nível pedido.
+inline bool interpreta_simd(const std::string& modo, NivelSimd& nivel) {
+    NivelSimd cpu = nivel_simd_cpu();
+    if (modo == "auto") nivel = cpu;
+    else if (modo == "scalar") nivel = NivelSimd::escalar;
+    else if (modo == "avx2") nivel = NivelSimd::avx2;
+    else if (modo == "avx512") nivel = NivelSimd::avx512;
+    else return false;
+    return nivel <= cpu;
+}
+
+// Sumidouro dos microbenchmarks: um valor gravado num volatile não pode ser
+// descartado pelo compilador, e com ele os cálculos medidos que o produziram.
+template <typename T>
+struct SumidouroMedicao {
+    static volatile T destino;
+};
+template <typename T>
+volatile T SumidouroMedicao<T>::destino;
+
+template <typename T>
+inline void consome_medicao(T valor) {
+    SumidouroMedicao<T>::destino = valor;
+}
+
+#endif
@@ -2,8 +2,9 @@
 #include <fstream>
 #include <vector>
 #include <algorithm>
-#include <stack>
 #include <string>
+#include <cstdio>
+#include "comum/grafos.h"
 
 using namespace std;
 
@@ -16,122 +17,187 @@ void print_help() {
     cout << "Uso: ./kosaraju -f <arquivo> [-o <saida>]" << endl;
     cout << "  -h : mostra este help" << endl;
     cout << "  -o : redireciona a saida para o arquivo" << endl;
-    cout << "  -f : indica o arquivo que contem o grafo de entrada" << endl;
+    cout << "  -f : indica o arquivo que contem o grafo de entrada ('-' para stdin)" << endl;
+    cout << "  -n : entrada sem cabecalho (V e M inferidos das arestas)" << endl;
+    cout << "  --reorder=bfs|rcm|degree : renumera os vertices para melhor localidade" << endl;
 }
 
 // Função de Leitura (para Grafo Direcionado, sem pesos)
-// Lê G (Grafo Original) e constrói GT (Grafo Transposto) simultaneamente
-bool read_graph(const string& filename, Grafo& G, Grafo& GT, int& num_vertices) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Erro: Nao foi possivel abrir o arquivo: " << filename << endl;
+// Lê G (Grafo Original) e constrói GT (Grafo Transposto) simultaneamente.
+// Formato "V M" + arestas "u v", ou só as arestas (ver LeitorArestas).
+// As arestas vão primeiro para uma arena; depois os graus são contados e
+// cada lista é alocada uma única vez, no tamanho exato.
+bool read_graph(const string& filename, Grafo& G, Grafo& GT, int& num_vertices, bool sem_cabecalho) {
+    LeitorArestas leitor(filename, false, sem_cabecalho);
+    if (!leitor.abre()) {
         return false;
     }
 
-    int num_edges;
-    // Tenta ler o número de vértices e arestas
-    if (!(file >> num_vertices >> num_edges)) {
-        cerr << "Erro ao ler V e M do arquivo." << endl;
+    ArenaBlocos<pair<int, int>> arestas;
+    int u, v, peso;
+    while (leitor.proxima(u, v, peso)) {
+        arestas.push_back({u, v});
+    }
+    if (leitor.erro()) {
         return false;
     }
+    num_vertices = leitor.num_vertices();
+
+    // Graus de saída (G) e de entrada (GT)
+    vector<int> grau_saida(num_vertices + 1, 0), grau_entrada(num_vertices + 1, 0);
+    for (size_t i = 0; i < arestas.size(); ++i) {
+        grau_saida[arestas[i].first]++;
+        grau_entrada[arestas[i].second]++;
+    }
 
     // Inicializa G (Grafo Original) e GT (Grafo Transposto)
     // Dimensionado para num_vertices + 1 para lidar com vértices 1-based
     G.assign(num_vertices + 1, vector<int>());
     GT.assign(num_vertices + 1, vector<int>());
+    for (int x = 1; x <= num_vertices; ++x) {
+        G[x].reserve(grau_saida[x]);
+        GT[x].reserve(grau_entrada[x]);
+    }
 
-    int u, v;
-    for (int i = 0; i < num_edges; ++i) {
-        if (!(file >> u >> v)) {
-            cerr << "Erro ao ler aresta " << i + 1 << "." << endl;
-            return false;
-        }
-        
+    for (size_t i = 0; i < arestas.size(); ++i) {
         // Grafo Original: Aresta u -> v
-        G[u].push_back(v);
+        G[arestas[i].first].push_back(arestas[i].second);
         
         // Grafo Transposto: Aresta v -> u (Direção invertida)
-        GT[v].push_back(u); 
+        GT[arestas[i].second].push_back(arestas[i].first);
     }
 
     return true;
 }
 
-
 // DFS para o Passo 1: Preenche a pilha com a ordem de finalização
-void DFS_Pass1(const Grafo& G, int u, vector<bool>& visitados, stack<int>& pilha_finalizacao) {
-    visitados[u] = true;
-    
-    // 1. Explorar Vizinhos
-    for (int v : G[u]) {
-        if (!visitados[v]) {
-            DFS_Pass1(G, v, visitados, pilha_finalizacao);
+// Iterativa: cada quadro guarda só {vértice, próximo vizinho} (8 bytes), em
+// vez de um quadro de recursão inteiro, o que evita estouro da pilha de
+// chamadas em grafos enormes.
+void DFS_Pass1(const Grafo& G, int raiz, vector<bool>& visitados, vector<int>& pilha_finalizacao,
+               vector<pair<int, int>>& quadros) {
+    visitados[raiz] = true;
+    quadros.push_back({raiz, 0});
+
+    while (!quadros.empty()) {
+        int u = quadros.back().first;
+        int& proximo = quadros.back().second;
+
+        // 1. Explorar Vizinhos
+        if (proximo < (int)G[u].size()) {
+            int v = G[u][proximo++];
+            if (!visitados[v]) {
+                visitados[v] = true;
+                quadros.push_back({v, 0});
+            }
+            continue;
         }
-    }
 
-    // 2. Ação: Adiciona o vértice à pilha APÓS visitar todos os seus descendentes.
-    pilha_finalizacao.push(u); 
+        // 2. Ação: Adiciona o vértice à pilha APÓS visitar todos os seus descendentes.
+        pilha_finalizacao.push_back(u);
+        quadros.pop_back();
+    }
 }
 
 // DFS para o Passo 2: Encontra a CFC no Grafo Transposto (GT)
-void DFS_Pass2(const Grafo& GT, int u, vector<bool>& visitados, vector<int>& componente_atual) {
-    visitados[u] = true;
+// Iterativa como a do Passo 1, com os mesmos quadros {vértice, próximo
+// vizinho}: os vértices entram na CFC em pré-ordem, na mesma ordem da
+// versão recursiva.
+void DFS_Pass2(const Grafo& GT, int raiz, vector<bool>& visitados, vector<int>& componente_atual,
+               vector<pair<int, int>>& quadros) {
+    visitados[raiz] = true;
     // 1. Ação: Adiciona o vértice à CFC que está sendo construída.
-    componente_atual.push_back(u); 
-    
-    // 2. Explorar Vizinhos (no grafo Transposto!)
-    for (int v : GT[u]) {
-        if (!visitados[v]) {
-            DFS_Pass2(GT, v, visitados, componente_atual);
+    componente_atual.push_back(raiz);
+    quadros.push_back({raiz, 0});
+
+    while (!quadros.empty()) {
+        int u = quadros.back().first;
+        int& proximo = quadros.back().second;
+
+        // 2. Explorar Vizinhos (no grafo Transposto!)
+        if (proximo < (int)GT[u].size()) {
+            int v = GT[u][proximo++];
+            if (!visitados[v]) {
+                visitados[v] = true;
+                componente_atual.push_back(v);
+                quadros.push_back({v, 0});
+            }
+            continue;
         }
+        quadros.pop_back();
     }
 }
 
 
+// Resultado compacto: os membros de todas as CFCs ficam contíguos em
+// 'membros' e a CFC c ocupa [inicio[c], inicio[c + 1]). São dois vetores no
+// total, em vez de uma alocação por componente.
+struct Componentes {
+    vector<int> inicio;
+    vector<int> membros;
+
+    int quantidade() const { return (int)inicio.size() - 1; }
+};
+
+// Área de trabalho do Kosaraju, reaproveitada entre execuções: os vetores
+// mantêm a capacidade, então chamadas repetidas não voltam ao alocador.
+struct AreaKosaraju {
+    vector<bool> visitados;
+    vector<int> pilha_finalizacao;
+    vector<pair<int, int>> quadros;
+};
+
 // Função principal do Algoritmo de Kosaraju
-// Retorna um vector<vector<int>> onde cada vector interno é uma CFC
-vector<vector<int>> kosaraju_algorithm(const Grafo& G, const Grafo& GT, int num_vertices) {
+// Preenche 'cfcs' (reaproveitando sua capacidade) com as CFCs do grafo
+void kosaraju_algorithm(const Grafo& G, const Grafo& GT, int num_vertices, Componentes& cfcs, AreaKosaraju& area) {
     
     // 1. Passo 1: DFS no Grafo Original (G) para obter a ordem de finalização
     
-    vector<bool> visitados(num_vertices + 1, false);
-    stack<int> pilha_finalizacao; 
+    // visitados é um bitset (vector<bool>); a pilha de finalização é um
+    // vetor reservado de uma vez (sem os blocos do deque do std::stack).
+    vector<bool>& visitados = area.visitados;
+    vector<int>& pilha_finalizacao = area.pilha_finalizacao;
+    visitados.assign(num_vertices + 1, false);
+    pilha_finalizacao.clear();
+    pilha_finalizacao.reserve(num_vertices);
 
     // Itera sobre todos os vértices (para lidar com grafos desconexos)
     for (int i = 1; i <= num_vertices; ++i) {
         if (!visitados[i]) {
-            DFS_Pass1(G, i, visitados, pilha_finalizacao); 
+            DFS_Pass1(G, i, visitados, pilha_finalizacao, area.quadros); 
         }
     }
     
     // 2. Passo 2: DFS no Grafo Transposto (GT) na Ordem Inversa de Finalização
     
-    vector<vector<int>> cfcs; // Resultado final
+    cfcs.inicio.clear();
+    cfcs.membros.clear();
+    cfcs.membros.reserve(num_vertices);
+    cfcs.inicio.push_back(0);
     fill(visitados.begin(), visitados.end(), false); // Reseta o vetor de visitados
     
     // Processa os vértices na ordem inversa (do topo da pilha para a base)
     while (!pilha_finalizacao.empty()) {
-        int u = pilha_finalizacao.top();
-        pilha_finalizacao.pop();
+        int u = pilha_finalizacao.back();
+        pilha_finalizacao.pop_back();
 
         // Se o vértice ainda não foi visitado, ele é o "líder" de uma nova CFC
         if (!visitados[u]) {
-            vector<int> componente_atual; // Vetor para a nova CFC
-            
-            // Executa DFS no GT a partir do líder para encontrar todos os membros da CFC
-            DFS_Pass2(GT, u, visitados, componente_atual);
+            // Executa DFS no GT a partir do líder; os membros são acrescentados
+            // ao final de cfcs.membros
+            DFS_Pass2(GT, u, visitados, cfcs.membros, area.quadros);
             
-            cfcs.push_back(componente_atual); 
+            cfcs.inicio.push_back((int)cfcs.membros.size()); 
         }
     }
-    
-    return cfcs;
 }
 
 
 int main(int argc, char* argv[]) {
     string filename = "";
     string output_file = "";
+    bool no_header = false;
+    string reorder = "";
 
     // 1. Parsing de Argumentos
     for (int i = 1; i < argc; ++i) {
@@ -141,8 +207,12 @@ int main(int argc, char* argv[]) {
             return 0;
         } else if (arg == "-f" && i + 1 < argc) {
             filename = argv[++i];
+        } else if (arg == "-n") {
+            no_header = true;
         } else if (arg == "-o" && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (arg.compare(0, 10, "--reorder=") == 0) {
+            reorder = arg.substr(10);
         }
     }
 
@@ -156,12 +226,37 @@ int main(int argc, char* argv[]) {
     int num_vertices;
     
     // 2. Leitura do Grafo
-    if (!read_graph(filename, G, GT, num_vertices)) {
+    if (!read_graph(filename, G, GT, num_vertices, no_header)) {
         return 1;
     }
 
+    // Reordenação opcional: o algoritmo roda no grafo permutado e as CFCs
+    // voltam para a numeração original.
+    vector<int> novo_id;
+    if (!reorder.empty()) {
+        // A vizinhança considerada é a de G e GT juntos (arestas sem direção)
+        auto vizinhanca = [&G, &GT](int v, vector<int>& saida) {
+            saida.insert(saida.end(), G[v].begin(), G[v].end());
+            saida.insert(saida.end(), GT[v].begin(), GT[v].end());
+        };
+        if (!calcula_ordem(num_vertices, reorder, vizinhanca, novo_id)) {
+            cerr << "Erro: Metodo de reordenacao invalido: " << reorder << endl;
+            return 1;
+        }
+        G = permuta_grafo(G, num_vertices, novo_id);
+        GT = permuta_grafo(GT, num_vertices, novo_id);
+    }
+
     // 3. Execução
-    vector<vector<int>> cfcs = kosaraju_algorithm(G, GT, num_vertices);
+    Componentes cfcs;
+    AreaKosaraju area;
+    kosaraju_algorithm(G, GT, num_vertices, cfcs, area);
+
+    if (!novo_id.empty()) {
+        vector<int> id_original(num_vertices + 1);
+        for (int v = 1; v <= num_vertices; ++v) id_original[novo_id[v]] = v;
+        for (int& vertice : cfcs.membros) vertice = id_original[vertice];
+    }
     
     // 4. Configuração da Saída
     ostream* out = &cout;
@@ -176,9 +271,9 @@ int main(int argc, char* argv[]) {
     }
     
     // 5. Output das Componentes Fortemente Conexas (CFCs)
-    for (const auto& cfc : cfcs) {
-        for (int vertice : cfc) {
-            *out << vertice << " ";
+    for (int c = 0; c < cfcs.quantidade(); ++c) {
+        for (int k = cfcs.inicio[c]; k < cfcs.inicio[c + 1]; ++k) {
+            *out << cfcs.membros[k] << " ";
         }
         *out << endl;
     }
@@ -6,6 +6,11 @@
 #include <sstream>
 #include <tuple>
 #include <cstdio>
+#include <queue>
+#include <limits>
+#include <map>
+#include <set>
+#include "comum/grafos.h"
 
 using namespace std;
 
@@ -54,35 +59,26 @@ public:
 using ArestaKruskal = tuple<int, int, int>; // {peso, u, v}
 using ListaArestas = vector<ArestaKruskal>;
 
-bool read_edges(const string& filename, ListaArestas& arestas, int& num_vertices) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Erro: Nao foi possivel abrir o arquivo: " << filename << endl;
-        return false;
-    }
-
-    int num_edges;
-    if (!(file >> num_vertices >> num_edges)) {
-        cerr << "Erro ao ler V e M do arquivo." << endl;
+// Lê as arestas de 'filename' (formato em LeitorArestas). Sem cabeçalho, M
+// não é conhecido de antemão e a lista cresce por duplicação: cada realocação
+// só toca as páginas já copiadas, então o pico fica abaixo de 2x o tamanho
+// final (uma arena seguida de cópia para a lista custaria exatamente 2x).
+bool read_edges(const string& filename, ListaArestas& arestas, int& num_vertices, bool sem_cabecalho) {
+    LeitorArestas leitor(filename, true, sem_cabecalho);
+    if (!leitor.abre()) {
         return false;
     }
+    arestas.reserve(max(leitor.num_arestas(), 0));
 
+    // Adiciona cada aresta à lista: {peso, u, v}
     int u, v, weight;
-    for (int i = 0; i < num_edges; ++i) {
-        if (!(file >> u >> v >> weight)) {
-            cerr << "Erro ao ler aresta " << i + 1 << "." << endl;
-            return false;
-        }
-
-        // Checagem de validade do vértice
-        if (u < 1 || u > num_vertices || v < 1 || v > num_vertices) {
-            cerr << "Erro: Vertice " << u << " ou " << v << " fora do intervalo [1, " << num_vertices << "]." << endl;
-            return false;
-        }
-
-        // Adiciona a aresta à lista: {peso, u, v}
-        arestas.emplace_back(weight, u, v); 
+    while (leitor.proxima(u, v, weight)) {
+        arestas.emplace_back(weight, u, v);
     }
+    if (leitor.erro()) {
+        return false;
+    }
+    num_vertices = leitor.num_vertices();
 
     return true;
 }
@@ -133,19 +129,985 @@ long long kruskal_algorithm(ListaArestas& arestas, int num_vertices, vector<pair
     return total_cost;
 }
 
+// ---------------------------------------------------------------------------
+// Modo dinâmico (-u): mantém a AGM em memória sob inserções, remoções e
+// alterações de peso, sem refazer o Kruskal do zero a cada atualização.
+// ---------------------------------------------------------------------------
+
+// Árvore Link-Cut (Sleator-Tarjan) com máximo no caminho.
+// As arestas da floresta também são nós: a aresta (u, v) de índice 'id' vira
+// o nó 'base + id', ligado a u e a v. Assim o máximo no caminho entre dois
+// vértices é sempre um nó-aresta, e sabemos qual aresta remover do ciclo.
+// Todas as operações custam O(log N) amortizado.
+class ArvoreLinkCut {
+private:
+    struct No {
+        int filho[2] = {0, 0};
+        int pai = 0;      // Pai na splay OU "path-parent" (se for raiz da splay)
+        bool inverte = false;
+        int valor = numeric_limits<int>::min();
+        int max_no = 0;   // Nó de maior 'valor' na subárvore da splay
+    };
+    vector<No> nos; // Índice 0 é o nó nulo
+
+    bool eh_raiz(int x) const {
+        int p = nos[x].pai;
+        return p == 0 || (nos[p].filho[0] != x && nos[p].filho[1] != x);
+    }
+
+    void empurra(int x) {
+        if (nos[x].inverte) {
+            swap(nos[x].filho[0], nos[x].filho[1]);
+            for (int c : nos[x].filho) {
+                if (c) nos[c].inverte = !nos[c].inverte;
+            }
+            nos[x].inverte = false;
+        }
+    }
+
+    void atualiza(int x) {
+        nos[x].max_no = x;
+        for (int c : nos[x].filho) {
+            if (c && nos[nos[c].max_no].valor > nos[nos[x].max_no].valor) {
+                nos[x].max_no = nos[c].max_no;
+            }
+        }
+    }
+
+    void rotaciona(int x) {
+        int p = nos[x].pai;
+        int g = nos[p].pai;
+        int lado = (nos[p].filho[1] == x);
+        int b = nos[x].filho[!lado];
+
+        if (!eh_raiz(p)) {
+            nos[g].filho[nos[g].filho[1] == p] = x;
+        }
+        nos[x].pai = g;
+
+        nos[x].filho[!lado] = p;
+        nos[p].pai = x;
+
+        nos[p].filho[lado] = b;
+        if (b) nos[b].pai = p;
+
+        atualiza(p);
+        atualiza(x);
+    }
+
+    void splay(int x) {
+        // Propaga as inversões pendentes do topo da splay até x (sem recursão)
+        pilha_aux.clear();
+        for (int y = x; ; y = nos[y].pai) {
+            pilha_aux.push_back(y);
+            if (eh_raiz(y)) break;
+        }
+        for (int i = (int)pilha_aux.size() - 1; i >= 0; --i) {
+            empurra(pilha_aux[i]);
+        }
+
+        while (!eh_raiz(x)) {
+            int p = nos[x].pai;
+            if (!eh_raiz(p)) {
+                int g = nos[p].pai;
+                bool zigzig = (nos[g].filho[1] == p) == (nos[p].filho[1] == x);
+                rotaciona(zigzig ? p : x);
+            }
+            rotaciona(x);
+        }
+    }
+
+    // Torna o caminho raiz -> x preferido; x termina como raiz da sua splay
+    void acessa(int x) {
+        for (int y = 0, z = x; z; y = z, z = nos[z].pai) {
+            splay(z);
+            nos[z].filho[1] = y;
+            atualiza(z);
+        }
+        splay(x);
+    }
+
+    // Torna x a raiz da sua árvore
+    void enraiza(int x) {
+        acessa(x);
+        nos[x].inverte = !nos[x].inverte;
+    }
+
+    int raiz(int x) {
+        acessa(x);
+        while (true) {
+            empurra(x);
+            if (!nos[x].filho[0]) break;
+            x = nos[x].filho[0];
+        }
+        splay(x);
+        return x;
+    }
+
+    vector<int> pilha_aux;
+
+public:
+    explicit ArvoreLinkCut(int N = 0) : nos(N + 1) {
+        for (int i = 0; i <= N; ++i) nos[i].max_no = i;
+    }
+
+    // Garante espaço para os nós 1..N
+    void reserva(int N) {
+        int antigo = (int)nos.size();
+        if (N + 1 > antigo) {
+            nos.resize(N + 1);
+            for (int i = antigo; i <= N; ++i) nos[i].max_no = i;
+        }
+    }
+
+    void define_valor(int x, int valor) {
+        acessa(x);
+        nos[x].valor = valor;
+        atualiza(x);
+    }
+
+    int valor(int x) const { return nos[x].valor; }
+
+    bool conectados(int x, int y) {
+        return x == y || raiz(x) == raiz(y);
+    }
+
+    // Pré-condição: x e y em árvores diferentes
+    void liga(int x, int y) {
+        enraiza(x);
+        nos[x].pai = y;
+    }
+
+    // Pré-condição: (x, y) é uma aresta da floresta
+    void corta(int x, int y) {
+        enraiza(x);
+        acessa(y);
+        // Agora x é o filho esquerdo de y na splay e não tem filho direito
+        nos[y].filho[0] = 0;
+        nos[x].pai = 0;
+        atualiza(y);
+    }
+
+    // Nó de maior valor no caminho x ... y (pré-condição: conectados)
+    int maximo_caminho(int x, int y) {
+        enraiza(x);
+        acessa(y);
+        return nos[y].max_no;
+    }
+};
+
+// Floresta de passeios de Euler (Euler-tour tree) sobre treaps. Cada árvore
+// da AGM é guardada como a sequência do seu passeio de Euler: cada vértice
+// tem um nó próprio e cada aresta da árvore vira dois nós-arco (ida e
+// volta). Ligar, cortar e achar a árvore de um vértice custam O(log N)
+// esperado. Cada vértice carrega uma marca (quantas arestas fora da AGM
+// incidem nele) e cada nó soma as marcas da sua subárvore, o que dá o total
+// de uma árvore em O(1) e permite visitar só os vértices marcados.
+class FlorestaEuler {
+private:
+    struct No {
+        int esq = 0, dir = 0, pai = 0;
+        unsigned prioridade = 0;
+        int tam = 1;        // Nós na subárvore da treap
+        int marca = 0;      // Só em nós-vértice
+        long long soma = 0; // Soma das marcas na subárvore
+    };
+    vector<No> nos; // Índice 0 é o nó nulo (tam 0)
+    unsigned semente = 2463534242u;
+
+    unsigned sorteia() {
+        semente ^= semente << 13;
+        semente ^= semente >> 17;
+        semente ^= semente << 5;
+        return semente;
+    }
+
+    void atualiza(int x) {
+        No& n = nos[x];
+        n.tam = 1 + nos[n.esq].tam + nos[n.dir].tam;
+        n.soma = n.marca + nos[n.esq].soma + nos[n.dir].soma;
+    }
+
+    // Concatena as sequências a e b; devolve a raiz
+    int junta(int a, int b) {
+        if (!a || !b) return a ? a : b;
+        if (nos[a].prioridade > nos[b].prioridade) {
+            nos[a].dir = junta(nos[a].dir, b);
+            nos[nos[a].dir].pai = a;
+            atualiza(a);
+            nos[a].pai = 0;
+            return a;
+        }
+        nos[b].esq = junta(a, nos[b].esq);
+        nos[nos[b].esq].pai = b;
+        atualiza(b);
+        nos[b].pai = 0;
+        return b;
+    }
+
+    // Divide a sequência t em a (os k primeiros nós) e b (o resto)
+    void divide(int t, int k, int& a, int& b) {
+        if (!t) {
+            a = b = 0;
+            return;
+        }
+        if (nos[nos[t].esq].tam < k) {
+            int resto;
+            divide(nos[t].dir, k - nos[nos[t].esq].tam - 1, resto, b);
+            nos[t].dir = resto;
+            if (resto) nos[resto].pai = t;
+            a = t;
+        } else {
+            int inicio;
+            divide(nos[t].esq, k, a, inicio);
+            nos[t].esq = inicio;
+            if (inicio) nos[inicio].pai = t;
+            b = t;
+        }
+        atualiza(t);
+        nos[t].pai = 0;
+    }
+
+    // Posição de x na sua sequência (0 = primeiro)
+    int posicao(int x) const {
+        int p = nos[nos[x].esq].tam;
+        for (; nos[x].pai; x = nos[x].pai) {
+            if (nos[nos[x].pai].dir == x) p += nos[nos[nos[x].pai].esq].tam + 1;
+        }
+        return p;
+    }
+
+    // Gira a sequência para começar no vértice v
+    int reenraiza(int v) {
+        int a, b;
+        divide(raiz(v), posicao(v), a, b);
+        return junta(b, a);
+    }
+
+    void inicializa(int x) {
+        nos[x] = No();
+        nos[x].prioridade = sorteia();
+    }
+
+public:
+    // Nós 1..N são os vértices; os nós-arco são reservados à parte
+    explicit FlorestaEuler(int N = 0) : nos(1) {
+        nos[0].tam = 0;
+        reserva(N);
+    }
+
+    void reserva(int N) {
+        int antigo = (int)nos.size();
+        if (N + 1 > antigo) {
+            nos.resize(N + 1);
+            for (int i = antigo; i <= N; ++i) inicializa(i);
+        }
+    }
+
+    // Identifica a árvore de x (a raiz da treap)
+    int raiz(int x) const {
+        while (nos[x].pai) x = nos[x].pai;
+        return x;
+    }
+
+    // Soma das marcas da árvore cuja raiz de treap é r
+    long long soma(int r) const { return nos[r].soma; }
+
+    // Liga u e v (em árvores diferentes) usando os nós-arco ida e volta
+    void liga(int u, int v, int ida, int volta) {
+        inicializa(ida);
+        inicializa(volta);
+        int tu = reenraiza(u);
+        int tv = reenraiza(v);
+        junta(junta(junta(tu, ida), tv), volta);
+    }
+
+    // Corta a aresta da árvore representada pelos nós-arco ida e volta
+    void corta(int ida, int volta) {
+        int r = raiz(ida);
+        int p1 = posicao(ida), p2 = posicao(volta);
+        if (p1 > p2) {
+            swap(p1, p2);
+            swap(ida, volta);
+        }
+        // Sequência: X ida Y volta Z  ->  Y fica sozinho; X e Z se juntam
+        int x, resto, arco, y, z;
+        divide(r, p1, x, resto);
+        divide(resto, 1, arco, resto);
+        divide(resto, p2 - p1 - 1, y, resto);
+        divide(resto, 1, arco, z);
+        junta(x, z);
+        inicializa(ida);
+        inicializa(volta);
+    }
+
+    void soma_marca(int v, int delta) {
+        nos[v].marca += delta;
+        for (int x = v; x; x = nos[x].pai) atualiza(x);
+    }
+
+    // Chama visita(v) para cada vértice marcado da árvore de raiz r,
+    // descendo só pelas subárvores com soma positiva
+    template <typename Visita>
+    void visita_marcados(int r, Visita visita) {
+        pilha_aux.clear();
+        if (nos[r].soma > 0) pilha_aux.push_back(r);
+        while (!pilha_aux.empty()) {
+            int x = pilha_aux.back();
+            pilha_aux.pop_back();
+            if (nos[x].marca > 0) visita(x);
+            if (nos[nos[x].esq].soma > 0) pilha_aux.push_back(nos[x].esq);
+            if (nos[nos[x].dir].soma > 0) pilha_aux.push_back(nos[x].dir);
+        }
+    }
+
+private:
+    vector<int> pilha_aux;
+};
+
+// AGM (ou Floresta Geradora Mínima) mantida sob atualizações.
+// - Inserção e diminuição de peso: O(log N) via árvore link-cut
+//   (troca a aresta mais pesada do ciclo formado, se for o caso).
+// - Remoção/aumento de aresta fora da AGM: O(1) / O(log N).
+// - Remoção/aumento de aresta da AGM: corta a aresta e procura a substituta
+//   só entre as arestas fora da AGM incidentes ao lado do corte que tem menos
+//   delas (a floresta de Euler dá esse total por árvore e visita só os
+//   vértices que as têm). Custa O(k log N), k = número dessas arestas: uma
+//   ponte que isola uma parte pequena do grafo sai barata, qualquer que
+//   seja o tamanho do resto.
+// Limite: esse último caso NÃO é polilogarítmico. Se os dois lados do corte
+// tiverem muitas arestas fora da AGM, k chega a O(M) e a operação custa
+// O(M log N), como recalcular do zero. O polilog amortizado exigiria a
+// hierarquia de níveis de Holm-de Lichtenberg-Thorup, não implementada aqui.
+class AGMDinamica {
+private:
+    struct ArestaDinamica {
+        int u, v, peso;
+        bool na_agm;
+        int pos_u, pos_v; // Posição em fora_da_agm[u] / [v] (fora da AGM)
+    };
+
+    int num_vertices;
+    ArvoreLinkCut lct;                      // Máximo no caminho (inserções)
+    FlorestaEuler euler;                    // Conectividade e busca de substituta
+    vector<ArestaDinamica> arestas;         // Indexado pelo id da aresta
+    vector<int> ids_livres;                 // Ids de arestas removidas (reaproveitados)
+    map<pair<int, int>, int> indice;        // {min(u,v), max(u,v)} -> id
+    vector<vector<int>> fora_da_agm;        // Por vértice: ids das arestas fora da AGM
+    long long custo = 0;
+
+    int no_da_aresta(int id) const { return num_vertices + 1 + id; }
+    int arco_ida(int id) const { return num_vertices + 1 + 2 * id; }
+    int arco_volta(int id) const { return num_vertices + 2 + 2 * id; }
+
+    static pair<int, int> chave(int u, int v) { return {min(u, v), max(u, v)}; }
+
+    void reserva_ids(int id) {
+        lct.reserva(no_da_aresta(id));
+        euler.reserva(arco_volta(id));
+    }
+
+    bool conectados(int u, int v) const { return euler.raiz(u) == euler.raiz(v); }
+
+    void coloca_na_agm(int id) {
+        ArestaDinamica& a = arestas[id];
+        int e = no_da_aresta(id);
+        lct.define_valor(e, a.peso);
+        lct.liga(a.u, e);
+        lct.liga(e, a.v);
+        euler.liga(a.u, a.v, arco_ida(id), arco_volta(id));
+        a.na_agm = true;
+        custo += a.peso;
+    }
+
+    void tira_da_agm(int id) {
+        ArestaDinamica& a = arestas[id];
+        int e = no_da_aresta(id);
+        lct.corta(a.u, e);
+        lct.corta(e, a.v);
+        euler.corta(arco_ida(id), arco_volta(id));
+        a.na_agm = false;
+        custo -= a.peso;
+    }
+
+    void adiciona_fora(int id) {
+        ArestaDinamica& a = arestas[id];
+        a.pos_u = (int)fora_da_agm[a.u].size();
+        fora_da_agm[a.u].push_back(id);
+        a.pos_v = (int)fora_da_agm[a.v].size();
+        fora_da_agm[a.v].push_back(id);
+        euler.soma_marca(a.u, 1);
+        euler.soma_marca(a.v, 1);
+    }
+
+    // Tira 'id' da lista do vértice x, na posição pos (troca com a última)
+    void tira_da_lista(int x, int pos) {
+        vector<int>& lista = fora_da_agm[x];
+        int movida = lista.back();
+        lista[pos] = movida;
+        lista.pop_back();
+        if (pos < (int)lista.size()) {
+            if (arestas[movida].u == x) arestas[movida].pos_u = pos;
+            else arestas[movida].pos_v = pos;
+        }
+        euler.soma_marca(x, -1);
+    }
+
+    void retira_fora(int id) {
+        ArestaDinamica& a = arestas[id];
+        tira_da_lista(a.u, a.pos_u);
+        tira_da_lista(a.v, a.pos_v);
+    }
+
+    // Depois de cortar a aresta (u, v) da AGM, religa as duas partes com a
+    // aresta mais leve que cruza o corte (menor {peso, id}), se houver
+    void procura_substituta(int u, int v) {
+        int ru = euler.raiz(u), rv = euler.raiz(v);
+        int lado = euler.soma(ru) <= euler.soma(rv) ? ru : rv;
+
+        int melhor = -1;
+        euler.visita_marcados(lado, [&](int x) {
+            for (int id : fora_da_agm[x]) {
+                const ArestaDinamica& a = arestas[id];
+                int outro = (a.u == x) ? a.v : a.u;
+                if (euler.raiz(outro) == lado) continue; // Não cruza o corte
+                if (melhor < 0 || make_pair(a.peso, id) < make_pair(arestas[melhor].peso, melhor)) {
+                    melhor = id;
+                }
+            }
+        });
+        if (melhor >= 0) {
+            retira_fora(melhor);
+            coloca_na_agm(melhor);
+        }
+        // Senão, nenhuma aresta cruza o corte: a floresta ganha um componente
+    }
+
+    // Decide se uma aresta nova (ainda fora de tudo) entra na AGM
+    void posiciona(int id) {
+        ArestaDinamica& a = arestas[id];
+        if (!conectados(a.u, a.v)) {
+            coloca_na_agm(id);
+            return;
+        }
+        // Ciclo: compara com a aresta mais pesada do caminho u ... v
+        int e_max = lct.maximo_caminho(a.u, a.v);
+        int id_max = e_max - num_vertices - 1;
+        if (lct.valor(e_max) > a.peso) {
+            tira_da_agm(id_max);
+            adiciona_fora(id_max);
+            coloca_na_agm(id);
+        } else {
+            adiciona_fora(id);
+        }
+    }
+
+public:
+    // Constrói a AGM inicial com o Kruskal tradicional (Union-Find)
+    AGMDinamica(int N, ListaArestas arestas_iniciais)
+        : num_vertices(N), lct(N), euler(N), fora_da_agm(N + 1) {
+        // Arestas paralelas: só a mais leve pode estar em alguma AGM
+        map<pair<int, int>, int> menor_peso;
+        for (const auto& aresta : arestas_iniciais) {
+            int w = get<0>(aresta), u = get<1>(aresta), v = get<2>(aresta);
+            if (u == v) continue; // Laço nunca entra na AGM
+            auto ins = menor_peso.insert({chave(u, v), w});
+            if (!ins.second) ins.first->second = min(ins.first->second, w);
+        }
+
+        ListaArestas unicas;
+        unicas.reserve(menor_peso.size());
+        for (const auto& par : menor_peso) {
+            unicas.emplace_back(par.second, par.first.first, par.first.second);
+        }
+
+        vector<pair<int, int>> mst_edges;
+        kruskal_algorithm(unicas, num_vertices, mst_edges);
+        set<pair<int, int>> na_agm(mst_edges.begin(), mst_edges.end());
+
+        // As arestas fora da AGM são marcadas antes de ligar a floresta:
+        // com os vértices ainda isolados, cada marca custa O(1)
+        arestas.reserve(unicas.size());
+        if (!unicas.empty()) reserva_ids((int)unicas.size() - 1);
+        vector<int> da_agm;
+        for (const auto& aresta : unicas) {
+            int id = (int)arestas.size();
+            int w = get<0>(aresta), u = get<1>(aresta), v = get<2>(aresta);
+            arestas.push_back({u, v, w, false, 0, 0});
+            indice[{u, v}] = id;
+            if (na_agm.count({u, v})) {
+                da_agm.push_back(id);
+            } else {
+                adiciona_fora(id);
+            }
+        }
+        for (int id : da_agm) coloca_na_agm(id);
+    }
+
+    // Insere a aresta (u, v); se ela já existe, equivale a alterar o peso
+    void insere(int u, int v, int peso) {
+        if (u == v) return;
+        auto it = indice.find(chave(u, v));
+        if (it != indice.end()) {
+            altera_peso(u, v, peso);
+            return;
+        }
+
+        int id;
+        if (!ids_livres.empty()) {
+            id = ids_livres.back();
+            ids_livres.pop_back();
+            arestas[id] = {u, v, peso, false, 0, 0};
+        } else {
+            id = (int)arestas.size();
+            arestas.push_back({u, v, peso, false, 0, 0});
+            reserva_ids(id);
+        }
+        indice[chave(u, v)] = id;
+        posiciona(id);
+    }
+
+    // Retorna false se a aresta não existe
+    bool remove(int u, int v) {
+        auto it = indice.find(chave(u, v));
+        if (it == indice.end()) return false;
+        int id = it->second;
+        indice.erase(it);
+        ids_livres.push_back(id);
+
+        if (arestas[id].na_agm) {
+            tira_da_agm(id);
+            procura_substituta(arestas[id].u, arestas[id].v);
+        } else {
+            retira_fora(id);
+        }
+        return true;
+    }
+
+    // Retorna false se a aresta não existe
+    bool altera_peso(int u, int v, int peso) {
+        auto it = indice.find(chave(u, v));
+        if (it == indice.end()) return false;
+        int id = it->second;
+        ArestaDinamica& a = arestas[id];
+
+        if (a.na_agm && peso <= a.peso) {
+            // Aresta da AGM ficou mais leve: a AGM não muda
+            custo += (long long)peso - a.peso;
+            a.peso = peso;
+            lct.define_valor(no_da_aresta(id), peso);
+        } else if (!a.na_agm && peso >= a.peso) {
+            // Aresta fora da AGM ficou mais pesada: a AGM não muda
+            a.peso = peso;
+        } else if (a.na_agm) {
+            // Aresta da AGM ficou mais pesada: pode haver substituta mais leve
+            // (ela mesma também concorre, pois agora está fora da AGM)
+            tira_da_agm(id);
+            a.peso = peso;
+            adiciona_fora(id);
+            procura_substituta(a.u, a.v);
+        } else {
+            // Aresta fora da AGM ficou mais leve: pode entrar no lugar de outra
+            retira_fora(id);
+            a.peso = peso;
+            posiciona(id);
+        }
+        return true;
+    }
+
+    long long custo_total() const { return custo; }
+
+    vector<pair<int, int>> arestas_agm() const {
+        vector<pair<int, int>> mst_edges;
+        for (const auto& par : indice) {
+            if (arestas[par.second].na_agm) mst_edges.push_back(par.first);
+        }
+        return mst_edges;
+    }
+
+    bool vertice_valido(int u) const { return u >= 1 && u <= num_vertices; }
+};
+
+// Processa o fluxo de atualizações, uma por linha:
+//   + u v peso   insere a aresta (u, v)
+//   - u v        remove a aresta (u, v)
+//   = u v peso   altera o peso da aresta (u, v)
+// Após cada atualização, escreve o custo atual da AGM em 'out'.
+bool process_updates(istream& in, AGMDinamica& agm, ostream& out) {
+    string linha;
+    int num_linha = 0;
+    while (getline(in, linha)) {
+        ++num_linha;
+        istringstream ss(linha);
+        char op;
+        int u, v, peso = 0;
+        if (!(ss >> op)) continue; // Linha vazia
+
+        if (!(ss >> u >> v) || ((op == '+' || op == '=') && !(ss >> peso))) {
+            cerr << "Erro ao ler atualizacao na linha " << num_linha << "." << endl;
+            return false;
+        }
+        if (!agm.vertice_valido(u) || !agm.vertice_valido(v)) {
+            cerr << "Erro: Vertice " << u << " ou " << v << " fora do intervalo na linha " << num_linha << "." << endl;
+            return false;
+        }
+
+        bool ok = true;
+        if (op == '+') {
+            agm.insere(u, v, peso);
+        } else if (op == '-') {
+            ok = agm.remove(u, v);
+        } else if (op == '=') {
+            ok = agm.altera_peso(u, v, peso);
+        } else {
+            cerr << "Erro: Operacao '" << op << "' desconhecida na linha " << num_linha << "." << endl;
+            return false;
+        }
+        if (!ok) {
+            cerr << "Aviso: Aresta (" << u << "," << v << ") inexistente na linha " << num_linha << "." << endl;
+        }
+
+        out << agm.custo_total() << '\n';
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Modo semi-externo (-m): para listas de arestas maiores que a memória.
+// Só o Union-Find (O(V)) fica inteiro em memória; as arestas são ordenadas
+// em blocos ("runs") que cabem no limite, gravados em arquivos temporários, e
+// depois intercaladas (k-way merge) direto no laço guloso do Kruskal.
+// ---------------------------------------------------------------------------
+
+// Leituras e gravações de runs passam por um pedaço fixo de ints na pilha,
+// para que nenhuma cópia do tamanho do bloco saia do orçamento.
+const size_t ARESTAS_POR_PEDACO = 1024;
+// Fan-in máximo de cada intercalação: limita os arquivos abertos ao mesmo tempo.
+const size_t MAX_RUNS_INTERCALACAO = 64;
+// Na última passada, se o bloco em memória deixar menos que isso (em arestas)
+// de buffer para cada run, ele também vai para o disco.
+const size_t MIN_BUFFER_RUN = 1024;
+
+// Lê sequencialmente um run gravado em disco. O buffer é uma fatia do
+// orçamento de arestas, emprestada por quem faz a intercalação.
+// Cada aresta é gravada como três int: {peso, u, v}.
+class LeitorRun {
+private:
+    FILE* arquivo;
+    ArestaKruskal* buffer;
+    size_t capacidade;
+    size_t pos = 0, fim = 0;
+
+    size_t enche() {
+        int pedaco[3 * ARESTAS_POR_PEDACO];
+        size_t lidas = 0;
+        while (lidas < capacidade) {
+            size_t quer = min(capacidade - lidas, ARESTAS_POR_PEDACO);
+            size_t n = fread(pedaco, 3 * sizeof(int), quer, arquivo);
+            for (size_t k = 0; k < n; ++k) {
+                buffer[lidas + k] = ArestaKruskal(pedaco[3 * k], pedaco[3 * k + 1], pedaco[3 * k + 2]);
+            }
+            lidas += n;
+            if (n < quer) break;
+        }
+        return lidas;
+    }
+
+public:
+    LeitorRun(FILE* f, ArestaKruskal* buf, size_t tam) : arquivo(f), buffer(buf), capacidade(tam) {
+        rewind(arquivo);
+    }
+
+    bool proxima(ArestaKruskal& aresta) {
+        if (pos == fim) {
+            fim = enche();
+            pos = 0;
+            if (fim == 0) return false;
+        }
+        aresta = buffer[pos++];
+        return true;
+    }
+};
+
+// Grava arestas num run acumulando-as num pedaço fixo.
+class EscritorRun {
+private:
+    FILE* arquivo;
+    int pedaco[3 * ARESTAS_POR_PEDACO];
+    size_t usados = 0;
+
+public:
+    explicit EscritorRun(FILE* f) : arquivo(f) {}
+
+    bool escreve(const ArestaKruskal& aresta) {
+        if (usados == ARESTAS_POR_PEDACO && !termina()) return false;
+        pedaco[3 * usados] = get<0>(aresta);
+        pedaco[3 * usados + 1] = get<1>(aresta);
+        pedaco[3 * usados + 2] = get<2>(aresta);
+        ++usados;
+        return true;
+    }
+
+    // Descarrega o pedaço pendente
+    bool termina() {
+        bool ok = fwrite(pedaco, 3 * sizeof(int), usados, arquivo) == usados;
+        usados = 0;
+        return ok;
+    }
+};
+
+// Ordena o bloco em memória e grava como um run temporário
+// (tmpfile: apagado automaticamente ao fechar).
+FILE* grava_run(ListaArestas& bloco) {
+    sort(bloco.begin(), bloco.end());
+    FILE* f = tmpfile();
+    if (!f) return nullptr;
+
+    EscritorRun escritor(f);
+    bool ok = true;
+    for (size_t i = 0; ok && i < bloco.size(); ++i) ok = escritor.escreve(bloco[i]);
+    if (!(ok && escritor.termina())) {
+        fclose(f);
+        return nullptr;
+    }
+    bloco.clear();
+    return f;
+}
+
+// Intercala (k-way merge) os runs e, opcionalmente, um bloco já ordenado em
+// memória, entregando as arestas em ordem a 'consome' (que devolve false para
+// parar). Os leitores dividem [buffer, buffer + tam_buffer) em fatias iguais
+// (não vazias: tam_buffer >= runs.size()).
+template <typename Consome>
+void intercala(const vector<FILE*>& runs, ArestaKruskal* buffer, size_t tam_buffer,
+               const ArestaKruskal* bloco, size_t tam_bloco, Consome consome) {
+    size_t por_leitor = runs.empty() ? 0 : tam_buffer / runs.size();
+    vector<LeitorRun> leitores;
+    leitores.reserve(runs.size());
+    for (size_t r = 0; r < runs.size(); ++r) leitores.emplace_back(runs[r], buffer + r * por_leitor, por_leitor);
+
+    // Heap com {aresta, origem}; origem == runs.size() é o bloco em memória
+    using ItemMerge = pair<ArestaKruskal, size_t>;
+    priority_queue<ItemMerge, vector<ItemMerge>, greater<ItemMerge>> heap;
+    size_t pos_bloco = 0;
+    ArestaKruskal aresta;
+    for (size_t r = 0; r < leitores.size(); ++r) {
+        if (leitores[r].proxima(aresta)) heap.push({aresta, r});
+    }
+    if (pos_bloco < tam_bloco) heap.push({bloco[pos_bloco++], runs.size()});
+
+    while (!heap.empty()) {
+        ItemMerge topo = heap.top();
+        heap.pop();
+
+        size_t r = topo.second;
+        if (r == runs.size()) {
+            if (pos_bloco < tam_bloco) heap.push({bloco[pos_bloco++], r});
+        } else if (leitores[r].proxima(aresta)) {
+            heap.push({aresta, r});
+        }
+        if (!consome(topo.first)) return;
+    }
+}
+
+// Junta os últimos 'quantos' runs num único run novo, fechando os antigos.
+bool junta_runs(vector<FILE*>& runs, vector<int>& niveis, size_t quantos,
+                ArestaKruskal* buffer, size_t tam_buffer) {
+    vector<FILE*> grupo(runs.end() - quantos, runs.end());
+    int nivel = niveis.back() + 1;
+    runs.resize(runs.size() - quantos);
+    niveis.resize(niveis.size() - quantos);
+
+    FILE* f = tmpfile();
+    bool ok = f != nullptr;
+    if (ok) {
+        EscritorRun escritor(f);
+        intercala(grupo, buffer, tam_buffer, nullptr, 0,
+                  [&](const ArestaKruskal& aresta) { return ok = escritor.escreve(aresta); });
+        ok = ok && escritor.termina();
+    }
+    for (FILE* g : grupo) fclose(g);
+    if (!ok) {
+        if (f) fclose(f);
+        return false;
+    }
+    runs.push_back(f);
+    niveis.push_back(nivel);
+    return true;
+}
+
+// O modo semi-externo nunca usa menos que o Union-Find mais o piso dos
+// buffers (ver kruskal_external); se -m não comporta isso, o limite pedido
+// será ultrapassado e o usuário é avisado.
+void avisa_memoria_minima(size_t memoria_bytes, int num_vertices) {
+    size_t minimo = sizeof(int) * ((size_t)num_vertices + 1) +
+                    MAX_RUNS_INTERCALACAO * MIN_BUFFER_RUN * sizeof(ArestaKruskal);
+    if (memoria_bytes < minimo) {
+        cerr << "Aviso: Limite de memoria (-m) abaixo do minimo para V=" << num_vertices
+             << " (minimo: " << ((minimo + (1 << 20) - 1) >> 20) << " MB); o limite sera ultrapassado." << endl;
+    }
+}
+
+// Kruskal semi-externo com no máximo ~memoria_bytes para as arestas.
+// A ordem global é a mesma do sort em memória (tuplas {peso, u, v}), então
+// o custo e a lista de arestas são idênticos aos do modo normal.
+//
+// Um único vetor de 'capacidade' arestas é o orçamento inteiro: na geração
+// ele é o bloco a ordenar; nas intercalações, a parte que o bloco não ocupa
+// vira os buffers dos leitores. Os runs são juntados como um contador na base
+// MAX_RUNS_INTERCALACAO (quando há MAX runs do mesmo nível, viram um run do
+// nível seguinte), então cada aresta é regravada O(log runs) vezes e só
+// O(MAX * níveis) arquivos ficam abertos.
+bool kruskal_external(const string& filename, size_t memoria_bytes, int& num_vertices,
+                      long long& total_cost, vector<pair<int, int>>& mst_edges, bool sem_cabecalho) {
+    LeitorArestas leitor(filename, true, sem_cabecalho);
+    if (!leitor.abre()) {
+        return false;
+    }
+    num_vertices = leitor.num_vertices();
+    int num_edges = leitor.num_arestas(); // -1 = desconhecido: lê até o fim da entrada
+
+    // O Union-Find (um int por vértice) sai do orçamento; o resto vai para as
+    // arestas. Sem cabeçalho, V só é conhecido no fim e não é descontado.
+    // Abaixo de MIN_BUFFER_RUN arestas por leitor na intercalação completa, os
+    // runs ficariam minúsculos e a quantidade de passadas explodiria: esse é o
+    // piso do orçamento (~768 KB).
+    size_t memoria_uf = sizeof(int) * ((size_t)num_vertices + 1);
+    size_t memoria_arestas = memoria_bytes > memoria_uf ? memoria_bytes - memoria_uf : 0;
+    size_t capacidade = max(memoria_arestas / sizeof(ArestaKruskal), MAX_RUNS_INTERCALACAO * MIN_BUFFER_RUN);
+    if (num_edges >= 0) avisa_memoria_minima(memoria_bytes, num_vertices);
+
+    // 1. Geração dos runs ordenados
+    ListaArestas bloco;
+    bloco.reserve(num_edges < 0 ? capacidade : min(capacidade, (size_t)num_edges));
+    vector<FILE*> runs;
+    vector<int> niveis; // nível de cada run: quantas vezes suas arestas já foram intercaladas
+    bool ok = true;
+
+    // Espaço livre do orçamento a partir de 'inicio', para os buffers dos
+    // leitores (o bloco já reservou 'capacidade', então não realoca)
+    auto area_livre = [&](size_t inicio) {
+        bloco.resize(capacidade);
+        return bloco.data() + inicio;
+    };
+
+    int u, v, weight;
+    int lidas = 0;
+    while (leitor.proxima(u, v, weight)) {
+        ++lidas;
+        bloco.emplace_back(weight, u, v);
+
+        // Bloco cheio e ainda há arestas: grava em disco.
+        // O último bloco fica em memória e entra direto na intercalação.
+        if (bloco.size() == capacidade && lidas != num_edges) {
+            FILE* f = grava_run(bloco);
+            if (!f) {
+                cerr << "Erro: Nao foi possivel gravar arquivo temporario." << endl;
+                ok = false;
+                break;
+            }
+            runs.push_back(f);
+            niveis.push_back(0);
+
+            // Com o bloco vazio, o orçamento inteiro serve de buffer
+            while (ok && runs.size() >= MAX_RUNS_INTERCALACAO &&
+                   niveis[runs.size() - MAX_RUNS_INTERCALACAO] == niveis.back()) {
+                ArestaKruskal* buffer = area_livre(0);
+                ok = junta_runs(runs, niveis, MAX_RUNS_INTERCALACAO, buffer, bloco.size());
+            }
+            bloco.clear();
+            if (!ok) {
+                cerr << "Erro: Nao foi possivel gravar arquivo temporario." << endl;
+                break;
+            }
+        }
+    }
+
+    if (leitor.erro()) ok = false;
+    num_vertices = leitor.num_vertices(); // Sem cabeçalho: o maior vértice lido
+    if (ok && num_edges < 0) avisa_memoria_minima(memoria_bytes, num_vertices);
+
+    if (ok) {
+        sort(bloco.begin(), bloco.end());
+        size_t tam_bloco = bloco.size();
+
+        // 2. Bloco final e buffers dividem o mesmo orçamento. Se sobra pouco
+        // para os leitores, o bloco final também vai para o disco.
+        size_t k = min(runs.size(), MAX_RUNS_INTERCALACAO);
+        if (k > 0 && tam_bloco > 0 && (capacidade - tam_bloco) / k < MIN_BUFFER_RUN) {
+            FILE* f = grava_run(bloco);
+            if (!f) {
+                cerr << "Erro: Nao foi possivel gravar arquivo temporario." << endl;
+                ok = false;
+            } else {
+                runs.push_back(f);
+                niveis.push_back(0);
+                tam_bloco = 0;
+            }
+        }
+
+        // 3. Passadas intermediárias: junta os runs mais recentes (os menores)
+        // até restarem no máximo MAX_RUNS_INTERCALACAO para a última.
+        ArestaKruskal* buffer = nullptr;
+        size_t tam_buffer = 0;
+        if (!runs.empty()) {
+            buffer = area_livre(tam_bloco);
+            tam_buffer = bloco.size() - tam_bloco;
+        }
+        while (ok && runs.size() > MAX_RUNS_INTERCALACAO) {
+            size_t quantos = min(runs.size() - MAX_RUNS_INTERCALACAO + 1, MAX_RUNS_INTERCALACAO);
+            ok = junta_runs(runs, niveis, quantos, buffer, tam_buffer);
+            if (!ok) cerr << "Erro: Nao foi possivel gravar arquivo temporario." << endl;
+        }
+
+        // 4. Laço guloso do Kruskal sobre o fluxo ordenado
+        if (ok) {
+            UnionFind uf(num_vertices);
+            total_cost = 0;
+            int edges_in_mst_count = 0;
+
+            intercala(runs, buffer, tam_buffer, bloco.data(), tam_bloco, [&](const ArestaKruskal& aresta) {
+                if (edges_in_mst_count >= num_vertices - 1) return false;
+                int w = get<0>(aresta);
+                int a = get<1>(aresta);
+                int b = get<2>(aresta);
+                if (uf.Union(a, b)) {
+                    total_cost += w;
+                    edges_in_mst_count++;
+                    mst_edges.push_back({min(a, b), max(a, b)});
+                }
+                return true;
+            });
+        }
+    }
+
+    for (FILE* f : runs) fclose(f);
+    return ok;
+}
+
 void print_help() {
-    cout << "Uso: ./kruskal -f <arquivo> [-s] [-o <saida>]" << endl;
+    cout << "Uso: ./kruskal -f <arquivo> [-s] [-o <saida>] [-u <atualizacoes>] [-m <MB>]" << endl;
     cout << "  -h : mostra este help" << endl;
     cout << "  -o : redireciona a saida para o arquivo" << endl;
-    cout << "  -f : indica o arquivo que contem o grafo de entrada" << endl;
+    cout << "  -f : indica o arquivo que contem o grafo de entrada ('-' para stdin)" << endl;
+    cout << "  -n : entrada sem cabecalho (V e M inferidos das arestas)" << endl;
     cout << "  -s : mostra a solucao" << endl;
     cout << "  -i : vertice inicial" << endl;
+    cout << "  -m : modo semi-externo: limita a memoria das arestas a <MB> megabytes" << endl;
+    cout << "       (ordenacao externa em arquivos temporarios)" << endl;
+    cout << "  -u : modo dinamico: aplica as atualizacoes do arquivo ('-' para stdin)" << endl;
+    cout << "       (+ u v peso | - u v | = u v peso) e mostra o custo apos cada uma" << endl;
+    cout << "       remover/aumentar aresta da AGM custa O(k log V), k = arestas fora da AGM" << endl;
+    cout << "       no lado menor do corte (pior caso O(M log V), nao polilogaritmico)" << endl;
 }   
 
 int main(int argc, char* argv[]) {
     string filename = "";
     bool show_solution = false;
     string output_file = "";
+    bool no_header = false;
+    string updates_file = "";
+    long long memory_mb = 0; // 0 = sem limite (tudo em memória)
     int start_node_ignored = -1; 
 
     for (int i = 1; i < argc; ++i) {
@@ -157,8 +1119,22 @@ int main(int argc, char* argv[]) {
             filename = argv[++i];
         } else if (arg == "-s") {
             show_solution = true;
+        } else if (arg == "-n") {
+            no_header = true;
         } else if (arg == "-o" && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (arg == "-u" && i + 1 < argc) {
+            updates_file = argv[++i];
+        } else if (arg == "-m" && i + 1 < argc) {
+            try {
+                memory_mb = stoll(argv[++i]);
+            } catch (...) {
+                memory_mb = -1;
+            }
+            if (memory_mb <= 0) {
+                cerr << "Erro: Limite de memoria (-m) invalido." << endl;
+                return 1;
+            }
         } else if (arg == "-i" && i + 1 < argc) {
             try {
                 start_node_ignored = stoi(argv[++i]);
@@ -170,18 +1146,27 @@ int main(int argc, char* argv[]) {
         print_help();
         return 1;
     }
+    if (filename == "-" && updates_file == "-") {
+        cerr << "Erro: -f e -u nao podem ler ambos da entrada padrao." << endl;
+        return 1;
+    }
     
     ListaArestas arestas;
     int num_vertices;
-    
-    if (!read_edges(filename, arestas, num_vertices)) {
+    vector<pair<int, int>> mst_edges;
+    long long cost = 0;
+
+    // Modo semi-externo: lê, ordena e processa as arestas sem carregá-las todas
+    // (o modo dinâmico precisa de todas as arestas em memória e ignora o -m)
+    bool external = (memory_mb > 0 && updates_file.empty());
+    if (external) {
+        if (!kruskal_external(filename, (size_t)memory_mb << 20, num_vertices, cost, mst_edges, no_header)) {
+            return 1;
+        }
+    } else if (!read_edges(filename, arestas, num_vertices, no_header)) {
         return 1;
     }
 
-    vector<pair<int, int>> mst_edges;
-    
-    long long cost = kruskal_algorithm(arestas, num_vertices, mst_edges);
-
     // Configuração da Saída (stdout ou arquivo)
     ostream* out = &cout;
     ofstream outfile;
@@ -193,6 +1178,36 @@ int main(int argc, char* argv[]) {
             cerr << "Erro: Nao foi possivel abrir o arquivo de saida: " << output_file << endl;
         }
     }
+
+    // Modo dinâmico: custo após cada atualização e, com -s, a AGM final
+    if (!updates_file.empty()) {
+        ifstream updates;
+        istream* in = &cin;
+        if (updates_file != "-") {
+            updates.open(updates_file);
+            if (!updates.is_open()) {
+                cerr << "Erro: Nao foi possivel abrir o arquivo de atualizacoes: " << updates_file << endl;
+                return 1;
+            }
+            in = &updates;
+        }
+
+        AGMDinamica agm(num_vertices, move(arestas));
+        if (!process_updates(*in, agm, *out)) {
+            return 1;
+        }
+        if (show_solution) {
+            for (const auto& edge : agm.arestas_agm()) {
+                *out << "(" << edge.first << "," << edge.second << ") ";
+            }
+            *out << '\n';
+        }
+        return 0;
+    }
+
+    if (!external) {
+        cost = kruskal_algorithm(arestas, num_vertices, mst_edges);
+    }
     
     // *** CORREÇÃO: Formatação de Saída (if/else) e printf ***
     if (show_solution) {
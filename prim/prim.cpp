@@ -6,6 +6,10 @@
 #include <algorithm>
 #include <sstream>
 #include <cstdio>
+#include <limits>
+#include <chrono>
+#include "comum/grafos.h"
+#include "comum/simd.h"
 
 using namespace std;
 
@@ -27,39 +31,40 @@ using PQ_Item = pair<int, int>; // {peso, destino}
 // Min-Heap de PQ_Item
 using MinHeap = priority_queue<PQ_Item, vector<PQ_Item>, greater<PQ_Item>>;
 
-bool read_graph(const string& filename, Grafo& adj, int& num_vertices) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Erro: Nao foi possivel abrir o arquivo: " << filename << endl;
-        return false;
-    }
+// Estado de cada vértice durante o Prim, compactado em 8 bytes.
+// O bit in_mst divide a palavra com o pai (0 = sem pai; vértices < 2^31).
+struct EstadoPrim {
+    int min_weight = 2e9; // 'infinito' grande o suficiente
+    unsigned parent_vertex : 31;
+    unsigned in_mst : 1;
 
-    int num_edges;
-    if (!(file >> num_vertices >> num_edges)) {
-        cerr << "Erro ao ler V e M do arquivo." << endl;
-        return false;
-    }
+    EstadoPrim() : parent_vertex(0), in_mst(0) {}
+};
 
-    // Inicializa a lista de adjacência (V+1 para grafos baseados em 1)
-    adj.assign(num_vertices + 1, vector<pair<int, int>>());
+// Área de trabalho do Prim, reaproveitada entre execuções: o estado por
+// vértice e a PQ são alocados uma vez. A cada nova execução só os vértices
+// tocados na anterior voltam ao estado inicial (custo O(tocados), não O(V)).
+struct AreaPrim {
+    vector<EstadoPrim> estado;
+    HeapReutilizavel<PQ_Item> pq;
+    vector<int> tocados;
+    vector<int> chave, pai; // Só do Prim denso, que percorre todos os vértices
 
-    int u, v, weight;
-    for (int i = 0; i < num_edges; ++i) {
-        if (!(file >> u >> v >> weight)) {
-            cerr << "Erro ao ler aresta " << i + 1 << "." << endl;
-            return false;
+    void prepara(int num_vertices) {
+        if (estado.size() != (size_t)num_vertices + 1) {
+            estado.assign(num_vertices + 1, EstadoPrim());
+        } else {
+            for (int v : tocados) estado[v] = EstadoPrim();
         }
-
-        // O grafo para AGM é não-direcionado, então adicionamos a aresta nas duas direções.
-        adj[u].push_back({v, weight});
-        adj[v].push_back({u, weight}); 
+        tocados.clear();
+        pq.limpa();
     }
-    return true;
-}
+};
 
 // Função para o Algoritmo de Prim
 // Retorna o custo total da AGM
-long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vector<pair<int, int>>& mst_edges) {
+long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vector<pair<int, int>>& mst_edges,
+                         AreaPrim& area) {
     // 1. Verificação inicial e estruturas auxiliares
     /*
     if (start_node <= 0 || start_node > num_vertices) {
@@ -72,25 +77,25 @@ long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vec
         return 0; 
     }
 
-    // in_mst[u] = true se o vértice u já foi incluído na AGM.
-    vector<bool> in_mst(num_vertices + 1, false); 
+    // Estado por vértice intercalado em 8 bytes (uma linha de cache cobre 8
+    // vértices), em vez de três vetores separados:
+    //   in_mst        : true se o vértice já foi incluído na AGM
+    //   min_weight    : menor peso de aresta que conecta o vértice à AGM atual
+    //   parent_vertex : vértice que trouxe este para a AGM pela aresta mínima
+    area.prepara(num_vertices);
+    vector<EstadoPrim>& estado = area.estado;
     
     // MinHeap: armazena as arestas candidatas {peso, destino}
-    MinHeap pq; 
+    MinHeap& pq = area.pq; 
     
     long long total_cost = 0;
     
     // Contará o número de arestas incluídas na AGM. Deve ser V-1.
     int edges_in_mst_count = 0; 
 
-    // min_weight[v] armazena o menor peso da aresta que conecta v à AGM atual.
-    vector<int> min_weight(num_vertices + 1, 2e9); // 'infinito' grande o suficiente
-    
-    // parent_vertex[v] armazena o vértice u que trouxe v para a AGM pela aresta mínima.
-    vector<int> parent_vertex(num_vertices + 1, -1);
-
     // 2. Inicialização do Algoritmo
-    min_weight[start_node] = 0;
+    estado[start_node].min_weight = 0;
+    area.tocados.push_back(start_node);
     // Adiciona o nó inicial com peso 0. Este item não representa uma aresta, mas inicia o processo.
     pq.push({0, start_node}); 
     
@@ -103,12 +108,12 @@ long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vec
         auto [weight, u] = pq.top();
         pq.pop();
 
-        if (in_mst[u]) {
+        if (estado[u].in_mst) {
             continue; // Já na AGM, ignore
         }
 
         // 4. Inclusão do Vértice 'u' na AGM
-        in_mst[u] = true;
+        estado[u].in_mst = true;
 
         // Se o peso for > 0, significa que esta é uma aresta real que conecta o
         // novo vértice 'u' à AGM (e não a iteração inicial de peso 0).
@@ -117,7 +122,7 @@ long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vec
             edges_in_mst_count++; // Aresta real adicionada
             
             // Registra a aresta (u, parent_vertex[u])
-            int p = parent_vertex[u];
+            int p = estado[u].parent_vertex;
 
             if (p > 0) {
                 mst_edges.push_back({min(u, p), max(u, p)}); 
@@ -131,11 +136,13 @@ long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vec
 
             // Se o vizinho 'v' não está na AGM E a aresta (u, v) é mais barata
             // do que a melhor aresta conhecida que conecta 'v' à AGM.
-            if (!in_mst[v] && edge_weight < min_weight[v]) {
+            EstadoPrim& ev = estado[v];
+            if (!ev.in_mst && edge_weight < ev.min_weight) {
                 
                 // Atualiza o peso mínimo e o pai para 'v'
-                min_weight[v] = edge_weight;
-                parent_vertex[v] = u;
+                if (ev.parent_vertex == 0) area.tocados.push_back(v);
+                ev.min_weight = edge_weight;
+                ev.parent_vertex = u;
                 
                 // Adiciona/Atualiza a aresta candidata na Fila de Prioridade
                 pq.push({edge_weight, v});
@@ -154,13 +161,253 @@ long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vec
     return total_cost;
 }
 
+long long prim_algorithm(const Grafo& adj, int num_vertices, int start_node, vector<pair<int, int>>& mst_edges) {
+    AreaPrim area;
+    return prim_algorithm(adj, num_vertices, start_node, mst_edges, area);
+}
+
+// ---------------------------------------------------------------------------
+// Prim denso, O(V^2): para grafos quase completos (C125-9, keller4, ...)
+// troca a PQ por uma varredura do vetor de chaves a cada passo. A varredura
+// (argmin) tem kernels AVX2 / AVX-512, escolhidos em tempo de execução
+// conforme a CPU, com a versão escalar como alternativa.
+// ---------------------------------------------------------------------------
+
+// Chave dos vértices já na AGM: nunca é o mínimo, então o argmin não
+// precisa de um vetor de marcação separado
+const int FORA = numeric_limits<int>::max();
+
+// Índice da primeira posição com o menor valor de chave[0..n)
+using KernelArgmin = int (*)(const int* chave, int n);
+
+int argmin_escalar(const int* chave, int n) {
+    int melhor = 0;
+    for (int i = 1; i < n; ++i) {
+        if (chave[i] < chave[melhor]) melhor = i;
+    }
+    return melhor;
+}
+
+#ifdef KERNELS_X86
+
+// 8 faixas, cada uma guardando seu menor valor e o índice dele. A
+// comparação estrita mantém o primeiro índice em caso de empate.
+__attribute__((target("avx2")))
+int argmin_avx2(const int* chave, int n) {
+    __m256i menor = _mm256_set1_epi32(FORA);
+    __m256i indice_menor = _mm256_setzero_si256();
+    __m256i indice = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i passo = _mm256_set1_epi32(8);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(chave + k));
+        __m256i menor_que = _mm256_cmpgt_epi32(menor, x);
+        menor = _mm256_blendv_epi8(menor, x, menor_que);
+        indice_menor = _mm256_blendv_epi8(indice_menor, indice, menor_que);
+        indice = _mm256_add_epi32(indice, passo);
+    }
+
+    alignas(32) int valores[8], indices[8];
+    _mm256_store_si256((__m256i*)valores, menor);
+    _mm256_store_si256((__m256i*)indices, indice_menor);
+    int melhor = 0;
+    for (int f = 1; f < 8; ++f) {
+        if (valores[f] < valores[melhor] || (valores[f] == valores[melhor] && indices[f] < indices[melhor])) {
+            melhor = f;
+        }
+    }
+    int resultado = indices[melhor], valor = valores[melhor];
+    for (; k < n; ++k) {
+        if (chave[k] < valor) {
+            valor = chave[k];
+            resultado = k;
+        }
+    }
+    return resultado;
+}
+
+// 16 faixas, mesma ideia; a comparação gera direto uma máscara de bits
+__attribute__((target("avx512f")))
+int argmin_avx512(const int* chave, int n) {
+    __m512i menor = _mm512_set1_epi32(FORA);
+    __m512i indice_menor = _mm512_setzero_si512();
+    __m512i indice = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i passo = _mm512_set1_epi32(16);
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i x = _mm512_loadu_si512((const void*)(chave + k));
+        __mmask16 menor_que = _mm512_cmplt_epi32_mask(x, menor);
+        menor = _mm512_mask_blend_epi32(menor_que, menor, x);
+        indice_menor = _mm512_mask_blend_epi32(menor_que, indice_menor, indice);
+        indice = _mm512_add_epi32(indice, passo);
+    }
+
+    alignas(64) int valores[16], indices[16];
+    _mm512_store_si512((void*)valores, menor);
+    _mm512_store_si512((void*)indices, indice_menor);
+    int melhor = 0;
+    for (int f = 1; f < 16; ++f) {
+        if (valores[f] < valores[melhor] || (valores[f] == valores[melhor] && indices[f] < indices[melhor])) {
+            melhor = f;
+        }
+    }
+    int resultado = indices[melhor], valor = valores[melhor];
+    for (; k < n; ++k) {
+        if (chave[k] < valor) {
+            valor = chave[k];
+            resultado = k;
+        }
+    }
+    return resultado;
+}
+
+#endif
+
+// Kernel em uso
+KernelArgmin kernel_argmin = argmin_escalar;
+
+// Liga o kernel do nível pedido em --simd (ver comum/simd.h); falha se o
+// modo for inválido ou a CPU não o suportar.
+bool seleciona_kernel(const string& modo) {
+    NivelSimd nivel;
+    if (!interpreta_simd(modo, nivel)) return false;
+    kernel_argmin = argmin_escalar;
+#ifdef KERNELS_X86
+    if (nivel == NivelSimd::avx512) {
+        kernel_argmin = argmin_avx512;
+    } else if (nivel == NivelSimd::avx2) {
+        kernel_argmin = argmin_avx2;
+    }
+#endif
+    return true;
+}
+
+// O Prim denso faz V varreduras de V chaves; compensa quando o grafo tem
+// uma fração grande das V^2 arestas possíveis (grau médio >= V / 4) e há
+// argmin vetorial. Com o escalar ele perde para a PQ (ver --bench).
+bool prim_denso_compensa(const Grafo& adj, int num_vertices) {
+    if (kernel_argmin == argmin_escalar) return false;
+    long long soma_graus = 0;
+    for (int u = 1; u <= num_vertices; ++u) soma_graus += adj[u].size();
+    return soma_graus * 4 >= (long long)num_vertices * num_vertices;
+}
+
+// Mesmo resultado (e mesma ordem de arestas) que prim_algorithm: o
+// argmin devolve o menor índice entre chaves iguais, exatamente o par
+// {peso, vértice} que a PQ entregaria primeiro.
+long long prim_denso(const Grafo& adj, int num_vertices, int start_node, vector<pair<int, int>>& mst_edges,
+                     AreaPrim& area) {
+    if (start_node <= 0 || start_node > num_vertices) {
+        return 0;
+    }
+
+    // chave[v]: menor peso de aresta ligando v à AGM (FORA se v já está nela)
+    vector<int>& chave = area.chave;
+    vector<int>& pai = area.pai;
+    chave.assign(num_vertices + 1, 2e9);
+    pai.assign(num_vertices + 1, 0);
+    chave[0] = FORA;
+
+    long long total_cost = 0;
+    int edges_in_mst_count = 0;
+    chave[start_node] = 0;
+
+    while (edges_in_mst_count < num_vertices - 1) {
+        int u = kernel_argmin(chave.data() + 1, num_vertices) + 1;
+        int weight = chave[u];
+        if (weight >= 2e9) break; // Resto inalcançável a partir de start_node
+        chave[u] = FORA;
+
+        if (weight > 0) {
+            total_cost += weight;
+            edges_in_mst_count++;
+            int p = pai[u];
+            if (p > 0) {
+                mst_edges.push_back({min(u, p), max(u, p)});
+            }
+        }
+
+        for (const auto& edge : adj[u]) {
+            int v = edge.first;
+            if (chave[v] != FORA && edge.second < chave[v]) {
+                chave[v] = edge.second;
+                pai[v] = u;
+            }
+        }
+    }
+    return total_cost;
+}
+
+// Microbenchmark (--bench): mede o argmin de cada kernel suportado sobre um
+// vetor de V chaves (o menor peso incidente a cada vértice) e o Prim
+// completo com PQ e denso com cada kernel. Resultados em stderr.
+// Deve ser chamado com o kernel de 'modo_simd' já selecionado: a decisão do
+// --dense=auto mostrada é a que a execução normal tomaria com ele.
+void bench_kernels(const Grafo& adj, int num_vertices, int start_node, const string& modo_simd) {
+    vector<int> chaves(num_vertices, 2e9);
+    long long soma_graus = 0;
+    for (int u = 1; u <= num_vertices; ++u) {
+        soma_graus += adj[u].size();
+        for (const auto& edge : adj[u]) chaves[u - 1] = min(chaves[u - 1], edge.second);
+    }
+    int rep_argmin = (int)max<long long>(1, 200000000LL / max(num_vertices, 1));
+    int rep_total = (int)max<long long>(1, 20000000LL / max<long long>(soma_graus + (long long)num_vertices * num_vertices / 8, 1));
+
+    AreaPrim area;
+    vector<pair<int, int>> mst_edges;
+    long long sumidouro = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rep_total; ++r) {
+        mst_edges.clear();
+        sumidouro += prim_algorithm(adj, num_vertices, start_node, mst_edges, area);
+    }
+    double heap = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / rep_total;
+
+    cerr << "V=" << num_vertices << " M=" << soma_graus / 2 << " denso automatico (--simd=" << modo_simd
+         << "): " << (prim_denso_compensa(adj, num_vertices) ? "sim" : "nao") << endl;
+    fprintf(stderr, "prim com PQ: %.1f us/execucao\n", heap);
+    cerr << "kernel    argmin(ns/chave)  ganho    prim denso(us/execucao)  vs PQ" << endl;
+
+    double ref_argmin = 0;
+    const char* modos[] = {"scalar", "avx2", "avx512"};
+    for (const char* modo : modos) {
+        if (!seleciona_kernel(modo)) {
+            cerr << modo << ": nao suportado nesta CPU" << endl;
+            continue;
+        }
+        auto t1 = chrono::steady_clock::now();
+        for (int r = 0; r < rep_argmin; ++r) {
+            chaves[r % num_vertices] ^= 1; // Impede que o resultado seja reaproveitado
+            sumidouro += kernel_argmin(chaves.data(), num_vertices);
+        }
+        auto t2 = chrono::steady_clock::now();
+        for (int r = 0; r < rep_total; ++r) {
+            mst_edges.clear();
+            sumidouro += prim_denso(adj, num_vertices, start_node, mst_edges, area);
+        }
+        auto t3 = chrono::steady_clock::now();
+
+        double argmin = chrono::duration<double, nano>(t2 - t1).count() / ((double)rep_argmin * num_vertices);
+        double denso = chrono::duration<double, micro>(t3 - t2).count() / rep_total;
+        if (ref_argmin == 0) ref_argmin = argmin;
+        fprintf(stderr, "%-9s %16.3f %6.2fx %24.1f %6.2fx\n", modo, argmin, ref_argmin / argmin, denso,
+                heap / denso);
+    }
+    consome_medicao(sumidouro);
+}
+
 void print_help() {
     cout << "Uso: ./prim -f <arquivo> -i <vertice_inicial> [-s] [-o <saida>]" << endl;
     cout << "  -h : mostra este help" << endl;
     cout << "  -o : redireciona a saida para o arquivo" << endl;
-    cout << "  -f : indica o arquivo que contem o grafo de entrada" << endl;
+    cout << "  -f : indica o arquivo que contem o grafo de entrada ('-' para stdin)" << endl;
+    cout << "  -n : entrada sem cabecalho (V e M inferidos das arestas)" << endl;
     cout << "  -s : mostra a solucao" << endl;
     cout << "  -i : vertice inicial (para o algoritmo de Prim)" << endl;
+    cout << "  --reorder=bfs|rcm|degree : renumera os vertices para melhor localidade" << endl;
+    cout << "  --dense=auto|on|off : Prim denso O(V^2) com argmin vetorial (padrao: pela densidade)" << endl;
+    cout << "  --simd=auto|scalar|avx2|avx512 : kernel do argmin (padrao: o melhor da CPU)" << endl;
+    cout << "  --bench : mede cada kernel e as duas versoes do Prim no grafo e mostra em stderr" << endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -168,6 +415,11 @@ int main(int argc, char* argv[]) {
     int start_node = -1; // Padrão é -1 (inválido)
     bool show_solution = false;
     string output_file = "";
+    bool no_header = false;
+    string reorder = "";
+    string dense = "auto";
+    string simd = "auto";
+    bool bench = false;
 
     // Loop simples para processar argumentos
     for (int i = 1; i < argc; ++i) {
@@ -186,8 +438,18 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-s") {
             show_solution = true;
+        } else if (arg == "-n") {
+            no_header = true;
         } else if (arg == "-o" && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (arg.compare(0, 10, "--reorder=") == 0) {
+            reorder = arg.substr(10);
+        } else if (arg.compare(0, 8, "--dense=") == 0) {
+            dense = arg.substr(8);
+        } else if (arg.compare(0, 7, "--simd=") == 0) {
+            simd = arg.substr(7);
+        } else if (arg == "--bench") {
+            bench = true;
         }
     }
 
@@ -204,13 +466,52 @@ int main(int argc, char* argv[]) {
     Grafo adj;
     int num_vertices;
     
-    if (!read_graph(filename, adj, num_vertices)) {
+    if (!read_graph(filename, adj, num_vertices, no_header)) {
+        return 1;
+    }
+
+    // Reordenação opcional: o algoritmo roda no grafo permutado e as arestas
+    // da AGM voltam para a numeração original.
+    vector<int> novo_id;
+    if (!reorder.empty()) {
+        if (!calcula_ordem(adj, num_vertices, reorder, novo_id)) {
+            cerr << "Erro: Metodo de reordenacao invalido: " << reorder << endl;
+            return 1;
+        }
+        adj = permuta_grafo(adj, num_vertices, novo_id);
+        if (start_node >= 1 && start_node <= num_vertices) {
+            start_node = novo_id[start_node];
+        }
+    }
+
+    if (!seleciona_kernel(simd)) {
+        cerr << "Erro: Kernel SIMD invalido ou nao suportado nesta CPU: " << simd << endl;
         return 1;
     }
+    if (dense != "auto" && dense != "on" && dense != "off") {
+        cerr << "Erro: Valor invalido para --dense: " << dense << endl;
+        return 1;
+    }
+    if (bench) {
+        bench_kernels(adj, num_vertices, start_node >= 1 && start_node <= num_vertices ? start_node : 1, simd);
+        return 0;
+    }
 
     vector<pair<int, int>> mst_edges;
     
-    long long cost = prim_algorithm(adj, num_vertices, start_node, mst_edges);
+    AreaPrim area;
+    bool usa_denso = dense == "on" || (dense == "auto" && prim_denso_compensa(adj, num_vertices));
+    long long cost = usa_denso ? prim_denso(adj, num_vertices, start_node, mst_edges, area)
+                               : prim_algorithm(adj, num_vertices, start_node, mst_edges, area);
+
+    if (!novo_id.empty()) {
+        vector<int> id_original(num_vertices + 1);
+        for (int v = 1; v <= num_vertices; ++v) id_original[novo_id[v]] = v;
+        for (auto& edge : mst_edges) {
+            int u = id_original[edge.first], v = id_original[edge.second];
+            edge = {min(u, v), max(u, v)};
+        }
+    }
     
     // Configuração da Saída (stdout ou arquivo)
     ostream* out = &cout;